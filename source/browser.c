@@ -1,10 +1,14 @@
-#include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "browser.h"
 #include "logging.h"
 #include "config.h"
+#include "prefetch.h"
+#include "glyph_atlas.h"
+#include "perf.h"
+#include "list_view.h"
+#include "grid_view.h"
 #include <SDL_image.h>
 #include <SDL_thread.h>
 #include <stdint.h>
@@ -13,6 +17,8 @@ typedef struct {
     char rom_path[MAX_PATH_LEN];
     char rom_name[MAX_PATH_LEN];
     int request_id;
+    int tile;               // Grid tile index, or -1 for the box art beside the list
+    uint32_t revision;      // Listing revision the grid tile belongs to
 } BoxArtRequest;
 
 int current_boxart_request_id = 0;
@@ -41,7 +47,7 @@ static const char* derive_system_name(const char* rom_path, const char* ext) {
 #endif
 
 SDL_Texture* render_text(SDL_Renderer *renderer, const char* text,
-                              TTF_Font *font, const SDL_Color color, SDL_Rect *rect, int is_favorites_view, const char* current_path) {
+                              TTF_Font *font, const SDL_Color color, SDL_Rect *rect) {
     SDL_Surface *surface;
     SDL_Texture *texture;
 
@@ -50,17 +56,7 @@ SDL_Texture* render_text(SDL_Renderer *renderer, const char* text,
         exit(1);
     }
 
-    // Check if this path is a favorite
-    char full_path[MAX_PATH_LEN * 2];  // Double buffer size to ensure space for path + filename
-    char display_text[MAX_PATH_LEN * 2 + 2];  // Extra space for "* " prefix
-    snprintf(full_path, MAX_PATH_LEN * 2, "%s/%s", current_path, text);
-
-    if (is_favorite(full_path) && !is_favorites_view) {
-        snprintf(display_text, sizeof(display_text), "* %s", text);
-        surface = TTF_RenderText_Blended(font, display_text, color);
-    } else {
-        surface = TTF_RenderText_Blended(font, text, color);
-    }
+    surface = TTF_RenderText_Blended(font, text, color);
 
     if (!surface) {
         log_message(LOG_ERROR, "TTF_RenderText_Blended failed: %s", TTF_GetError());
@@ -74,6 +70,8 @@ SDL_Texture* render_text(SDL_Renderer *renderer, const char* text,
         SDL_FreeSurface(surface);
         exit(1);
     }
+    perf_count(PERF_TEXT_RASTERS, 1);
+    perf_count(PERF_TEXTURES_ALIVE, 1);
 
     rect->w = surface->w;
     rect->h = surface->h;
@@ -83,13 +81,10 @@ SDL_Texture* render_text(SDL_Renderer *renderer, const char* text,
 }
 
 #if LOAD_ARTWORK
-static int boxart_loader_thread(void *data) {
-    BoxArtRequest *req = (BoxArtRequest *)data;
+// Decodes the box art of the requested ROM, or returns NULL if it has none
+static SDL_Surface* load_box_art_surface(const BoxArtRequest *req) {
     const char *ext = strrchr(req->rom_name, '.');
-    if (!ext) {
-        free(req);
-        return 0;
-    }
+    if (!ext) return NULL;
     ext++; // Skip the dot
     const char* system_name = derive_system_name(req->rom_path, ext);
 
@@ -102,21 +97,79 @@ static int boxart_loader_thread(void *data) {
     int path_len = snprintf(box_art_path, sizeof(box_art_path),
              "%s/media/%s/2dboxart/",
              ROMLAUNCHER_DATA_DIRECTORY, system_name);
-    if (path_len <= 0 || (size_t)path_len >= sizeof(box_art_path)) {
-        free(req);
-        return 0;
-    }
+    if (path_len <= 0 || (size_t)path_len >= sizeof(box_art_path)) return NULL;
     strncat(box_art_path, rom_basename, sizeof(box_art_path) - path_len - 5);
     strcat(box_art_path, ".png");
 
     FILE* test = fopen(box_art_path, "r");
-    if (!test) {
-         free(req);
-         return 0;
-    }
+    if (!test) return NULL;
     fclose(test);
 
-    SDL_Surface* surface = IMG_Load(box_art_path);
+    return IMG_Load(box_art_path);
+}
+
+// Shrinks box art to fit a grid tile, so a resident tile costs at most a
+// tile's worth of pixels however large the image is
+static SDL_Surface* fit_grid_tile(SDL_Surface* surface) {
+    float scale = SDL_min((float)GRID_TILE_W / surface->w, (float)GRID_ART_H / surface->h);
+    if (scale >= 1) return surface;
+
+    int w = SDL_max(1, (int)(surface->w * scale));
+    int h = SDL_max(1, (int)(surface->h * scale));
+    SDL_Surface* thumbnail = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (thumbnail) {
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        if (SDL_BlitScaled(surface, NULL, thumbnail, NULL) != 0) {
+            SDL_FreeSurface(thumbnail);
+            thumbnail = NULL;
+        }
+    }
+    SDL_FreeSurface(surface);
+    return thumbnail;
+}
+
+// Loads a grid tile unless it scrolled away while the loader queued
+static GridTile* load_grid_tile_surface(const BoxArtRequest *req) {
+    if (!grid_view_wanted(req->revision, req->tile)) return NULL;
+
+    SDL_Surface* surface = load_box_art_surface(req);
+    if (surface) surface = fit_grid_tile(surface);
+    if (!surface) return NULL;
+
+    GridTile* tile = malloc(sizeof(GridTile));
+    if (!tile) {
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+    tile->surface = surface;
+    tile->revision = req->revision;
+    tile->index = req->tile;
+    return tile;
+}
+
+// Every grid load ends with an event, carrying no tile if there was no art,
+// so the main thread starts the loads waiting for this one to finish. The
+// load stops counting against the cap before the event can be handled.
+static void load_grid_tile_file(BoxArtRequest *req) {
+    GridTile* tile = load_grid_tile_surface(req);
+    grid_view_load_done();
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    event.user.code = GRID_EVENT_CODE;
+    event.user.data1 = tile;
+    if (SDL_PushEvent(&event) <= 0) grid_view_free_tile(tile);
+}
+
+static int load_box_art_file(BoxArtRequest *req) {
+    if (req->tile >= 0) {
+        load_grid_tile_file(req);
+        free(req);
+        return 0;
+    }
+
+    SDL_Surface* surface = load_box_art_surface(req);
     if (!surface) {
          free(req);
          return 0;
@@ -139,198 +192,90 @@ static int boxart_loader_thread(void *data) {
     free(req);
     return 0;
 }
-#endif
-
-static int compare_strings(const void* a, const void* b) {
-    return strcmp(*(const char**)a, *(const char**)b);
-}
 
-static void truncate_text(TTF_Font* font, char* text, int max_width) {
-    int w, h;
-    TTF_SizeText(font, text, &w, &h);
-    if (w <= max_width) return;
-    const char *ellipsis = "...";
-    int ellipsis_w;
-    TTF_SizeText(font, ellipsis, &ellipsis_w, &h);
-    int target_width = max_width - ellipsis_w;
-    int len = strlen(text);
-    while (len > 0) {
-        text[len-1] = '\0';
-        TTF_SizeText(font, text, &w, &h);
-        if (w <= target_width) break;
-        len = strlen(text);
-    }
-    strcat(text, ellipsis);
+static int boxart_loader_thread(void *data) {
+    int result = load_box_art_file((BoxArtRequest *)data);
+    perf_count(PERF_BOXART_JOBS, -1);
+    return result;
 }
+#endif
 
-DirContent* list_files(const char* path) {
-    log_message(LOG_INFO, "Starting to list files");
-
-    DIR *dir;
-    struct dirent *entry;
-
-    DirContent* content = malloc(sizeof(DirContent));
-    if (!content) return NULL;
-
-    content->dirs = calloc(MAX_ENTRIES, sizeof(char*));
-    content->files = calloc(MAX_ENTRIES, sizeof(char*));
-    content->dir_textures = calloc(MAX_ENTRIES, sizeof(SDL_Texture*));
-    content->file_textures = calloc(MAX_ENTRIES, sizeof(SDL_Texture*));
-    content->dir_rects = calloc(MAX_ENTRIES, sizeof(SDL_Rect));
-    content->file_rects = calloc(MAX_ENTRIES, sizeof(SDL_Rect));
-
-    if (!content->dirs || !content->files || !content->dir_textures ||
-        !content->file_textures || !content->dir_rects || !content->file_rects) {
-        free(content->dirs);
-        free(content->files);
-        free(content->dir_textures);
-        free(content->file_textures);
-        free(content->dir_rects);
-        free(content->file_rects);
-        free(content);
-        return NULL;
-    }
-
-    content->dir_count = 0;
-    content->file_count = 0;
-    content->box_art_texture = NULL;
-
-    dir = opendir(path);
-    if (dir == NULL) {
-        log_message(LOG_INFO, "Failed to open directory: %s", path);
-        free(content->dirs);
-        free(content->files);
-        free(content);
-        return NULL;
-    }
-
-    log_message(LOG_INFO, "Listing contents of: %s", path);
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (content->dir_count >= MAX_ENTRIES || content->file_count >= MAX_ENTRIES) {
-            log_message(LOG_INFO, "Maximum number of entries reached");
-            break;
-        }
-
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        char *name = strdup(entry->d_name);
-        if (name == NULL) continue;
+static HighlightMode highlight_mode = HIGHLIGHT_BAR;
 
-        if (entry->d_type == DT_DIR) {
-            content->dirs[content->dir_count++] = name;
-        } else {
-            content->files[content->file_count++] = name;
-        }
-    }
+// Label of one listing row, starting at x: prefix, then the first
+// name_length bytes of name, cut to label_length bytes plus an ellipsis when
+// it is too wide
+typedef struct {
+    int x;
+    const char* prefix;
+    const char* name;
+    size_t name_length;
+    size_t label_length;    // Set by fit_label()
+    int width;              // Set by fit_label()
+} RowLabel;
+
+// Fills in the label of row index from a snapshot
+// Returns 0 if the snapshot does not hold that row
+static int row_label(const ListingSnapshot* listing, int index, RowLabel* label) {
+    int i = index - listing->row_base;
+    if (i < 0 || i >= listing->row_count) return 0;
+
+    const ListingRow* row = &listing->rows[i];
+    label->x = (row->flags & ENTRY_HEADER) ? LIST_VIEW_LEFT - GROUP_HEADER_OUTDENT : LIST_VIEW_LEFT;
+    if (row->flags & ENTRY_IS_DIR) label->prefix = "[DIR] ";
+    else label->prefix = (row->flags & ENTRY_FAVORITE) ? "* " : "";
+    label->name = row->name;
+    label->name_length = row->name_length;
+    label->label_length = row->name_length;
+    label->width = 0;
+    return 1;
+}
 
-    if (content->dir_count > 0) {
-        qsort(content->dirs, content->dir_count, sizeof(char*), compare_strings);
-        log_message(LOG_INFO, "Directories:");
-        for (int i = 0; i < content->dir_count; i++) {
-            log_message(LOG_DEBUG, "[DIR] %s", content->dirs[i]);
-            content->dir_rects[i].x = 50;
-            content->dir_rects[i].y = 50 + ((i % ENTRIES_PER_PAGE) * 40);
-            content->dir_textures[i] = NULL;
-        }
-    }
+static int label_truncated(const RowLabel* label) {
+    return label->label_length < label->name_length;
+}
 
-    if (content->file_count > 0) {
-        qsort(content->files, content->file_count, sizeof(char*), compare_strings);
-        log_message(LOG_DEBUG, "Files:");
-        for (int i = 0; i < content->file_count; i++) {
-            log_message(LOG_DEBUG, "%s", content->files[i]);
-            content->file_rects[i].x = 50;
-            int virtual_index = content->dir_count + i;
-            content->file_rects[i].y = 50 + ((virtual_index % ENTRIES_PER_PAGE) * 40);
-            content->file_textures[i] = NULL;
-        }
+// Truncates a row label to max_width. The name is walked once, glyph by
+// glyph, only as far as it fits; if it doesn't fit whole it is cut back
+// further to leave room for the ellipsis by a binary search over the widths
+// that walk recorded.
+static void fit_label(GlyphAtlas* atlas, RowLabel* label, int max_width) {
+    int prefix_width = glyph_atlas_measure(atlas, label->prefix, strlen(label->prefix));
+    int available = max_width - prefix_width;
+    int name_width;
+    int widths[SNAPSHOT_NAME_MAX];
+    size_t fits = glyph_atlas_fit(atlas, label->name, label->name_length, available, &name_width, widths);
+    int w = prefix_width + name_width;
+
+    if (fits < label->name_length) {
+        int ellipsis_width = glyph_atlas_measure(atlas, LABEL_ELLIPSIS, strlen(LABEL_ELLIPSIS));
+        fits = glyph_atlas_refit(widths, fits, available - ellipsis_width, &name_width);
+        w = prefix_width + name_width + ellipsis_width;
     }
 
-    closedir(dir);
-    return content;
+    label->label_length = fits;
+    label->width = w;
 }
 
-void go_up_directory(DirContent* content, char* current_path, const char* rom_directory) {
-    char *last_slash = strrchr(current_path, '/');
-    if (last_slash && strcmp(current_path, rom_directory) != 0) {
-        *last_slash = '\0';
-
-        // Clear box art texture when changing directories
-        if (content->box_art_texture) {
-            SDL_DestroyTexture(content->box_art_texture);
-            content->box_art_texture = NULL;
-        }
-
-        for (int i = 0; i < content->dir_count; i++) {
-            free(content->dirs[i]);
-            if (content->dir_textures[i]) SDL_DestroyTexture(content->dir_textures[i]);
-        }
-        for (int i = 0; i < content->file_count; i++) {
-            free(content->files[i]);
-            if (content->file_textures[i]) SDL_DestroyTexture(content->file_textures[i]);
-        }
-
-        DirContent* new_content = list_files(current_path);
-        if (new_content) {
-            content->dirs = new_content->dirs;
-            content->files = new_content->files;
-            content->dir_count = new_content->dir_count;
-            content->file_count = new_content->file_count;
-            content->dir_textures = new_content->dir_textures;
-            content->file_textures = new_content->file_textures;
-            content->dir_rects = new_content->dir_rects;
-            content->file_rects = new_content->file_rects;
-            free(new_content);
-        }
+// Draws a row label with its top at y
+static void draw_label(GlyphAtlas* atlas, const RowLabel* label, SDL_Color color, int y) {
+    int x = glyph_atlas_draw(atlas, label->prefix, strlen(label->prefix), label->x, y, color);
+    x = glyph_atlas_draw(atlas, label->name, label->label_length, x, y, color);
+    if (label_truncated(label)) {
+        glyph_atlas_draw(atlas, LABEL_ELLIPSIS, strlen(LABEL_ELLIPSIS), x, y, color);
     }
 }
 
-void change_directory(DirContent* content, int selected_index, char* current_path) {
-    if (!content || selected_index >= content->dir_count) return;
-
-    char new_path[MAX_PATH_LEN];
-    snprintf(new_path, MAX_PATH_LEN, "%s/%s", current_path, content->dirs[selected_index]);
-    strncpy(current_path, new_path, MAX_PATH_LEN - 1);
-    current_path[MAX_PATH_LEN - 1] = '\0';
-
-    // Clear box art texture when changing directories
-    if (content->box_art_texture) {
-        SDL_DestroyTexture(content->box_art_texture);
-        content->box_art_texture = NULL;
-    }
-
-    for (int i = 0; i < content->dir_count; i++) {
-        free(content->dirs[i]);
-        if (content->dir_textures[i]) SDL_DestroyTexture(content->dir_textures[i]);
-    }
-    for (int i = 0; i < content->file_count; i++) {
-        free(content->files[i]);
-        if (content->file_textures[i]) SDL_DestroyTexture(content->file_textures[i]);
-    }
-
-    DirContent* new_content = list_files(current_path);
-    if (new_content) {
-        content->dirs = new_content->dirs;
-        content->files = new_content->files;
-        content->dir_count = new_content->dir_count;
-        content->file_count = new_content->file_count;
-        content->dir_textures = new_content->dir_textures;
-        content->file_textures = new_content->file_textures;
-        content->dir_rects = new_content->dir_rects;
-        content->file_rects = new_content->file_rects;
-        free(new_content);
-    }
+// The message shown in place of an empty favorites or history list
+static int is_placeholder_message(const DirContent* content) {
+    if (!(content->is_favorites_view || content->is_history_view) || content->file_count != 1) return 0;
+    const char* name = dir_content_file_name(content, 0);
+    return strstr(name, "No history yet") || strstr(name, "Use the X button");
 }
 
 void load_box_art(DirContent* content, const char* rom_path, const char* rom_name) {
-    // Free any existing box art texture first to prevent memory leaks
-    if (content->box_art_texture) {
-        SDL_DestroyTexture(content->box_art_texture);
-        content->box_art_texture = NULL;
-    }
+    // The old box art stops showing until the new one arrives
+    content->box_art = 0;
 
     if (!rom_name) return;
     // Cancel any previous box art loading request by incrementing the global request ID
@@ -342,175 +287,290 @@ void load_box_art(DirContent* content, const char* rom_path, const char* rom_nam
     strncpy(req->rom_name, rom_name, MAX_PATH_LEN - 1);
     req->rom_name[MAX_PATH_LEN - 1] = '\0';
     req->request_id = current_boxart_request_id;
+    req->tile = -1;
+    req->revision = 0;
 
 #if LOAD_ARTWORK
     // Spawn asynchronous thread to load box art
-    SDL_CreateThread(boxart_loader_thread, "BoxArtLoader", req);
+    perf_count(PERF_BOXART_JOBS, 1);
+    if (!SDL_CreateThread(boxart_loader_thread, "BoxArtLoader", req)) {
+        perf_count(PERF_BOXART_JOBS, -1);
+        free(req);
+    }
 #endif
 }
 
-void free_dir_content(DirContent* content) {
+#if LOAD_ARTWORK
+int load_grid_tile(const char* rom_path, const char* rom_name, uint32_t revision, int index) {
+    BoxArtRequest* req = malloc(sizeof(BoxArtRequest));
+    if (!req) return 0;
+    strncpy(req->rom_path, rom_path, MAX_PATH_LEN - 1);
+    req->rom_path[MAX_PATH_LEN - 1] = '\0';
+    strncpy(req->rom_name, rom_name, MAX_PATH_LEN - 1);
+    req->rom_name[MAX_PATH_LEN - 1] = '\0';
+    req->request_id = 0;
+    req->tile = index;
+    req->revision = revision;
+
+    perf_count(PERF_BOXART_JOBS, 1);
+    if (!SDL_CreateThread(boxart_loader_thread, "BoxArtLoader", req)) {
+        perf_count(PERF_BOXART_JOBS, -1);
+        free(req);
+        return 0;
+    }
+    return 1;
+}
+#else
+// Without artwork no loader ever starts
+int load_grid_tile(const char* rom_path __attribute__((unused)), const char* rom_name __attribute__((unused)),
+                   uint32_t revision __attribute__((unused)), int index __attribute__((unused))) {
+    return 0;
+}
+#endif
+
+void set_selection(DirContent* content, int selected_index, const char* current_path) {
     if (!content) return;
 
-    if (content->box_art_texture) {
-        SDL_DestroyTexture(content->box_art_texture);
-        content->box_art_texture = NULL;
+    if (content->is_history_view) {
+        log_message(LOG_DEBUG, "Setting selection for history view with %d entries", content->file_count);
+        prefetch_request(NULL);
+        return;
     }
 
-    // Free directory entries
-    if (content->dirs) {
-        for (int i = 0; i < content->dir_count; i++) {
-            if (content->dirs[i]) {
-                free(content->dirs[i]);
-                content->dirs[i] = NULL;
-            }
-            if (content->dir_textures && content->dir_textures[i]) {
-                SDL_DestroyTexture(content->dir_textures[i]);
-                content->dir_textures[i] = NULL;
-            }
-        }
+    // The grid shows its own thumbnails instead of the box art beside the list
+    int grid = grid_view_enabled() && !content->is_favorites_view;
+    if (!grid && selected_index >= content->dir_count &&
+        selected_index < content->dir_count + content->file_count) {
+        int file_index = selected_index - content->dir_count;
+        load_box_art(content, current_path, dir_content_file_name(content, file_index));
     }
 
-    // Free file entries
-    if (content->files) {
-        for (int i = 0; i < content->file_count; i++) {
-            if (content->files[i]) {
-                free(content->files[i]);
-                content->files[i] = NULL;
-            }
-            if (content->file_textures && content->file_textures[i]) {
-                SDL_DestroyTexture(content->file_textures[i]);
-                content->file_textures[i] = NULL;
-            }
-        }
+    // Read the highlighted subdirectory ahead if the cursor rests on it
+    if (selected_index >= 0 && selected_index < content->dir_count && !content->is_favorites_view) {
+        char dir_path[MAX_PATH_LEN];
+        int len = snprintf(dir_path, sizeof(dir_path), "%s/%s", current_path,
+                           dir_content_dir_name(content, selected_index));
+        prefetch_request(len < MAX_PATH_LEN ? dir_path : NULL);
+    } else {
+        prefetch_request(NULL);
     }
+}
 
-    // Free favorite groups structure if this was a favorites view
-    if (content->is_favorites_view && content->groups) {
-        FavoriteGroup* group = content->groups;
-        while (group) {
-            FavoriteEntry* entry = group->entries;
-            while (entry) {
-                FavoriteEntry* next_entry = entry->next;
-                if (entry->path) free(entry->path);
-                if (entry->display_name) free(entry->display_name);
-                free(entry);
-                entry = next_entry;
-            }
-            FavoriteGroup* next_group = group->next;
-            if (group->group_name) free(group->group_name);
-            free(group);
-            group = next_group;
-        }
-        content->groups = NULL;
+// Copies row index of content into a snapshot row
+static void snapshot_row(const DirContent* content, int index, ListingRow* row) {
+    const char* name;
+    size_t length;
+    if (index < content->dir_count) {
+        row->flags = ENTRY_IS_DIR;
+        name = dir_content_dir_name(content, index);
+        length = strlen(name);
+    } else {
+        // History shows whole names. Elsewhere files drop their extension and
+        // favorites are marked, except in the favorites view itself.
+        int i = index - content->dir_count;
+        uint8_t flags = content->files.flags[i];
+        int favorite = (flags & ENTRY_FAVORITE) && !content->is_favorites_view && !content->is_history_view;
+        row->flags = (flags & ENTRY_HEADER) | (favorite ? ENTRY_FAVORITE : 0);
+        name = dir_content_file_name(content, i);
+        length = content->is_history_view ? strlen(name) : content->files.display_length[i];
     }
 
-    // Free arrays
-    if (content->dirs) free(content->dirs);
-    if (content->files) free(content->files);
-    if (content->dir_textures) free(content->dir_textures);
-    if (content->file_textures) free(content->file_textures);
-    if (content->dir_rects) free(content->dir_rects);
-    if (content->file_rects) free(content->file_rects);
-    
-    free(content);
+    if (length >= SNAPSHOT_NAME_MAX) length = SNAPSHOT_NAME_MAX - 1;
+    memcpy(row->name, name, length);
+    row->name[length] = '\0';
+    row->name_length = (uint16_t)length;
 }
 
+void snapshot_listing(DirContent* content, int selected_index, int first_row,
+                      ListingSnapshot* snapshot) {
+    static const DirContent* shown_content = NULL;
+    static int shown_generation = -1;
+    static uint32_t shown_id = 0;
 
-void set_selection(DirContent* content, SDL_Renderer *renderer, TTF_Font *font,
-                  int selected_index, int current_page, const char* current_path) {
+    snapshot->present = content != NULL;
     if (!content) return;
 
-    char log_buf[MAX_PATH_LEN];
+    int generation = listing_generation();
+    if (content != shown_content || generation != shown_generation) {
+        shown_content = content;
+        shown_generation = generation;
+        shown_id++;
+    }
+    snapshot->id = shown_id;
+    snapshot->revision = dir_content_revision(content);
+    snapshot->total = content->dir_count + content->file_count;
+    snapshot->first_row = first_row;
+    snapshot->selected = selected_index;
+    snapshot->placeholder = is_placeholder_message(content);
+    snapshot->untruncated = content->is_history_view;
+    snapshot->dir_count = content->dir_count;
+    snapshot->file_count = content->file_count;
+    snapshot->bytes = dir_content_bytes(content);
+
+    int start = snapshot->first_row - ENTRIES_PER_PAGE;
+    if (start < 0) start = 0;
+    int end = snapshot->first_row + 2 * ENTRIES_PER_PAGE + 1;
+    if (end > snapshot->total) end = snapshot->total;
+    if (start > end) start = end;
+    snapshot->row_base = start;
+    snapshot->row_count = end - start;
+    for (int i = start; i < end; i++) {
+        snapshot_row(content, i, &snapshot->rows[i - start]);
+    }
+}
 
-    int start_index = current_page * ENTRIES_PER_PAGE;
-    int end_index = start_index + ENTRIES_PER_PAGE;
+typedef struct {
+    GlyphAtlas* atlas;
+    const ListingSnapshot* listing;
+    int max_width;
+} ListingRows;
+
+// Draws one listing row with its top at y
+static void draw_listing_row(void* data, int index, int y) {
+    ListingRows* rows = (ListingRows*)data;
+    RowLabel label;
+    if (!row_label(rows->listing, index, &label)) return;
+    fit_label(rows->atlas, &label, rows->max_width);
+    draw_label(rows->atlas, &label, COLOR_TEXT, y);
+}
 
-    // Special handling for history view
-    if (content->is_history_view) {
-        log_message(LOG_DEBUG, "Setting selection for history view with %d entries", content->file_count);
-        for (int i = 0; i < content->file_count; i++) {
-            if (i < start_index || i >= end_index) {
-                if (content->file_textures[i]) {
-                    SDL_DestroyTexture(content->file_textures[i]);
-                    content->file_textures[i] = NULL;
-                }
-                continue;
-            }
-
-            if (content->file_textures[i]) {
-                SDL_DestroyTexture(content->file_textures[i]);
-            }
-
-            content->file_textures[i] = render_text(renderer, content->files[i], font,
-                i == selected_index ? COLOR_TEXT_HIGHLIGHT : COLOR_TEXT,
-                &content->file_rects[i], 0, current_path);
-
-            log_message(LOG_DEBUG, "Rendered history entry %d: %s", i, content->files[i]);
-        }
-        return;
+int draw_listing(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing) {
+    static uint32_t shown_id = 0;
+    if (!listing->present) return 0;
+
+    GlyphAtlas* atlas = glyph_atlas_get(renderer, font);
+    if (!atlas) return 0;
+
+    // History labels are never truncated
+    ListingRows rows = { atlas, listing, listing->untruncated ? UINT16_MAX : LABEL_MAX_WIDTH };
+
+    // A placeholder message is centered on the screen above the status bar
+    if (listing->placeholder) {
+        RowLabel label;
+        if (!row_label(listing, 0, &label)) return 0;
+        fit_label(atlas, &label, UINT16_MAX);
+        label.x = (SCREEN_W - label.width) / 2;
+        draw_label(atlas, &label, COLOR_TEXT, (SCREEN_H - glyph_atlas_height(atlas) - STATUS_BAR_HEIGHT) / 2);
+        return 0;
     }
 
-    for (int i = 0; i < content->dir_count; i++) {
-        if (i < start_index || i >= end_index) {
-            if (content->dir_textures[i]) {
-                SDL_DestroyTexture(content->dir_textures[i]);
-                content->dir_textures[i] = NULL;
-            }
-            continue;
-        }
-        snprintf(log_buf, sizeof(log_buf), "[DIR] %s", content->dirs[i]);
-        truncate_text(font, log_buf, 860);
-        if (content->dir_textures[i]) {
-            SDL_DestroyTexture(content->dir_textures[i]);
-        }
-        content->dir_textures[i] = render_text(renderer, log_buf, font,
-            i == selected_index ? COLOR_TEXT_HIGHLIGHT : COLOR_TEXT, &content->dir_rects[i], content->is_favorites_view, current_path);
+    // Turning pages slides the list; a new listing is shown straight away
+    int same_listing = listing->id == shown_id;
+    shown_id = listing->id;
+    list_view_scroll_to(listing->first_row, same_listing);
+    list_view_update(SDL_GetTicks());
+
+    int start_index, end_index;
+    list_view_visible(listing->total, &start_index, &end_index);
+    RowLabel selected;
+    int highlighted = listing->selected >= start_index && listing->selected < end_index &&
+                      row_label(listing, listing->selected, &selected);
+
+    SDL_Rect viewport = list_view_viewport();
+    SDL_RenderSetClipRect(renderer, &viewport);
+
+    // The bar goes under the text, which then never changes colour
+    if (highlight_mode == HIGHLIGHT_BAR && highlighted) {
+        SDL_Rect row = { selected.x, list_view_row_y(listing->selected),
+                         LABEL_MAX_WIDTH, glyph_atlas_height(atlas) };
+        draw_selection_bar(renderer, &row);
     }
 
-    for (int i = 0; i < content->file_count; i++) {
-        int virtual_index = content->dir_count + i;
-        if (virtual_index < start_index || virtual_index >= end_index) {
-            if (content->file_textures[i]) {
-                SDL_DestroyTexture(content->file_textures[i]);
-                content->file_textures[i] = NULL;
-            }
-            continue;
+    // Rows that don't fit in this frame's budget show as placeholders.
+    // Highlighted text is drawn only in its own colour, since blending it
+    // over the normal row would leave a fringe of the other colour.
+    int hidden = (highlight_mode == HIGHLIGHT_TEXT && highlighted) ? listing->selected : -1;
+    if (!list_view_draw(renderer, font, glyph_atlas_height(atlas), listing->revision,
+                        listing->total, listing->selected, hidden, draw_listing_row, &rows)) {
+        // Without render targets every row is drawn each frame
+        for (int i = start_index; i < end_index; i++) {
+            if (i != hidden) draw_listing_row(&rows, i, list_view_row_y(i));
         }
-        // Get filename without extension
-        char display_name[MAX_PATH_LEN];
-        strncpy(display_name, content->files[i], MAX_PATH_LEN - 1);
-        display_name[MAX_PATH_LEN - 1] = '\0';
-
-        // Find and remove extension
-        char *dot = strrchr(display_name, '.');
-        if (dot) *dot = '\0';
-
-        snprintf(log_buf, sizeof(log_buf), "%s", display_name);
-        if (content->file_textures[i]) {
-            SDL_DestroyTexture(content->file_textures[i]);
+    }
+
+    // Highlighted text goes where its row was left out
+    if (hidden >= 0) {
+        fit_label(atlas, &selected, rows.max_width);
+        draw_label(atlas, &selected, COLOR_TEXT_HIGHLIGHT, list_view_row_y(listing->selected));
+    }
+    SDL_RenderSetClipRect(renderer, NULL);
+    return list_view_scrolling() || list_view_pending();
+}
+
+void draw_grid(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing, int top_row) {
+    if (!listing->present) return;
+
+    GlyphAtlas* atlas = glyph_atlas_get(renderer, font);
+    if (!atlas) return;
+
+    int start = top_row * GRID_COLUMNS;
+    int end = start + GRID_PAGE;
+    if (end > listing->total) end = listing->total;
+    for (int i = start; i < end; i++) {
+        SDL_Rect tile = grid_view_tile_rect(i, top_row);
+        int selected = i == listing->selected;
+        int label_y = tile.y + tile.h + GRID_LABEL_GAP;
+
+        // The bar frames the whole tile, label included
+        if (selected && highlight_mode == HIGHLIGHT_BAR) {
+            SDL_Rect row = { tile.x, tile.y - SELECTION_BAR_PADDING, tile.w,
+                             label_y + glyph_atlas_height(atlas) + 2 * SELECTION_BAR_PADDING - tile.y };
+            draw_selection_bar(renderer, &row);
         }
-        truncate_text(font, log_buf, 860);
-        int entry_index = content->dir_count + i;
-
-        // Special handling for the "no favorites" or "no history" message
-        if ((content->is_favorites_view || content->is_history_view) && content->file_count == 1 && i == 0 &&
-            (strstr(content->files[i], "No history yet") || strstr(content->files[i], "Use the X button"))) {
-            // Render the text first to get its dimensions
-            SDL_Texture* texture = render_text(renderer, log_buf, font, COLOR_TEXT, &content->file_rects[i], content->is_favorites_view, current_path);
-            // Center the text on screen
-            content->file_rects[i].x = (1280 - content->file_rects[i].w) / 2;  // Assuming 1280x720 screen
-            content->file_rects[i].y = (720 - content->file_rects[i].h - STATUS_BAR_HEIGHT) / 2;  // Account for status bar
-            content->file_textures[i] = texture;
-            log_message(LOG_DEBUG, "Centered special message: %s at (%d, %d)",
-                       content->files[i], content->file_rects[i].x, content->file_rects[i].y);
+
+        // Art is centered in the tile; until it arrives, or if there is
+        // none, the tile is a plain block
+        SDL_Rect art;
+        SDL_Texture* texture = grid_view_texture(listing->revision, i, &art);
+        if (texture) {
+            art.x = tile.x + (tile.w - art.w) / 2;
+            art.y = tile.y + (tile.h - art.h) / 2;
+            SDL_RenderCopy(renderer, texture, NULL, &art);
         } else {
-            content->file_textures[i] = render_text(renderer, log_buf, font,
-                entry_index == selected_index ? COLOR_TEXT_HIGHLIGHT : COLOR_TEXT, &content->file_rects[i], content->is_favorites_view, current_path);
+            SDL_SetRenderDrawColor(renderer, COLOR_GRID_TILE.r, COLOR_GRID_TILE.g,
+                                   COLOR_GRID_TILE.b, COLOR_GRID_TILE.a);
+            SDL_RenderFillRect(renderer, &tile);
         }
+
+        RowLabel label;
+        if (!row_label(listing, i, &label)) continue;
+        fit_label(atlas, &label, GRID_TILE_W);
+        label.x = tile.x + (tile.w - label.width) / 2;
+        SDL_Color color = (selected && highlight_mode == HIGHLIGHT_TEXT) ? COLOR_TEXT_HIGHLIGHT : COLOR_TEXT;
+        draw_label(atlas, &label, color, label_y);
     }
-    if (selected_index >= content->dir_count && selected_index < content->dir_count + content->file_count) {
-        int file_index = selected_index - content->dir_count;
-        load_box_art(content, current_path, content->files[file_index]);
-    }
+}
+
+int prerender_listing(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing) {
+    if (!listing->present || listing->placeholder) return 0;
+
+    GlyphAtlas* atlas = glyph_atlas_get(renderer, font);
+    if (!atlas) return 0;
+
+    // The next page is the likelier turn, so it goes first
+    ListingRows rows = { atlas, listing, listing->untruncated ? UINT16_MAX : LABEL_MAX_WIDTH };
+    int height = glyph_atlas_height(atlas);
+    int next = listing->first_row + ENTRIES_PER_PAGE;
+    int next_end = SDL_min(next + ENTRIES_PER_PAGE + 1, listing->row_base + listing->row_count);
+    int previous = SDL_max(listing->first_row - ENTRIES_PER_PAGE, listing->row_base);
+    return list_view_prerender(renderer, font, height, listing->revision, next, next_end,
+                               draw_listing_row, &rows) ||
+           list_view_prerender(renderer, font, height, listing->revision, previous, listing->first_row,
+                               draw_listing_row, &rows);
+}
+
+void set_highlight_mode(HighlightMode mode) {
+    highlight_mode = mode;
+}
+
+HighlightMode get_highlight_mode(void) {
+    return highlight_mode;
+}
+
+void draw_selection_bar(SDL_Renderer *renderer, const SDL_Rect* row) {
+    SDL_Rect bar = { row->x - SELECTION_BAR_PADDING, row->y,
+                     row->w + 2 * SELECTION_BAR_PADDING, row->h };
+    SDL_SetRenderDrawColor(renderer, COLOR_SELECTION_BAR.r, COLOR_SELECTION_BAR.g,
+                           COLOR_SELECTION_BAR.b, COLOR_SELECTION_BAR.a);
+    SDL_RenderFillRect(renderer, &bar);
 }
@@ -4,56 +4,121 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include "config.h"
+#include "dir_content.h"
+#include "navigation.h"
 
-#define MAX_ENTRIES 1024
 #define ENTRIES_PER_PAGE 15
 #define BOXART_MAX_WIDTH 350
+#define LABEL_MAX_WIDTH 860
+#define LABEL_ELLIPSIS "..."
+#define SELECTION_BAR_PADDING 10
+#define GROUP_HEADER_OUTDENT 20     // Favorites group headings stick out left
 
-// External declarations
-extern int current_boxart_request_id;
-extern int is_favorite(const char *path);
-extern void toggle_favorite(const char *path);
+// Longest name a listing snapshot keeps; far wider than a row can show
+#define SNAPSHOT_NAME_MAX 256
+// Rows in a listing snapshot: the current page and the pages either side
+// of it, which is as far as the list view strays from it mid-scroll and
+// what it pre-renders while idle
+#define SNAPSHOT_ROWS (3 * ENTRIES_PER_PAGE + 1)
 
-typedef struct FavoriteEntry {
-    char *path;
-    char *display_name;
-    struct FavoriteEntry *next;
-} FavoriteEntry;
+// How the selected row or menu item is shown
+typedef enum {
+    HIGHLIGHT_BAR,      // A filled bar behind text drawn in the normal colour
+    HIGHLIGHT_TEXT      // The text itself drawn in COLOR_TEXT_HIGHLIGHT
+} HighlightMode;
 
-typedef struct FavoriteGroup {
-    char *group_name;
-    FavoriteEntry *entries;
-    int entry_count;
-    struct FavoriteGroup *next;
-} FavoriteGroup;
+// One row of a listing snapshot
+typedef struct {
+    uint8_t flags;          // ENTRY_* bits; ENTRY_FAVORITE only where the marker shows
+    uint16_t name_length;   // Bytes of name the label shows
+    char name[SNAPSHOT_NAME_MAX];
+} ListingRow;
 
+// Everything draw_listing() needs of a listing, copied out of the DirContent
+// so the render thread never reads one the main thread is changing
 typedef struct {
-    char **dirs;
-    char **files;
-    int dir_count;
+    int present;            // 0 when there is no listing to draw
+    uint32_t id;            // Changes when a different listing is shown
+    uint32_t revision;      // dir_content_revision() when the snapshot was taken
+    int total;              // Rows in the whole listing
+    int first_row;          // Top row of the current page
+    int selected;
+    int placeholder;        // Row 0 is a message to center on screen
+    int untruncated;        // Labels show whole names (history)
+    int dir_count;          // Listing size, for the perf HUD
     int file_count;
-    SDL_Texture **dir_textures;
-    SDL_Texture **file_textures;
-    SDL_Rect *dir_rects;
-    SDL_Rect *file_rects;
-    FavoriteGroup *groups;  // Used only for favorites view
-    int is_favorites_view;
-    int is_history_view;    // Flag for history view
-    SDL_Texture *box_art_texture;
-    SDL_Rect box_art_rect;
-} DirContent;
+    size_t bytes;
+    int row_base;           // Listing index of rows[0]
+    int row_count;
+    ListingRow rows[SNAPSHOT_ROWS];
+} ListingSnapshot;
+
+// External declarations
+extern int current_boxart_request_id;
+extern int is_favorite(const char *path);
+extern void toggle_favorite(const char *path);
 
 // Function to load box art for a ROM
 void load_box_art(DirContent* content, const char* rom_path, const char* rom_name);
 
 // Function declarations
 SDL_Texture* render_text(SDL_Renderer *renderer, const char* text,
-                        TTF_Font *font, const SDL_Color color, SDL_Rect *rect, int is_favorites_view, const char* current_path);
-DirContent* list_files(const char* path);
-void go_up_directory(DirContent* content, char* current_path, const char* rom_directory);
-void change_directory(DirContent* content, int selected_index, char* current_path);
-void set_selection(DirContent* content, SDL_Renderer *renderer, TTF_Font *font,
-                  int selected_index, int current_page, const char* current_path);
-void free_dir_content(DirContent* content);
+                        TTF_Font *font, const SDL_Color color, SDL_Rect *rect);
+void set_selection(DirContent* content, int selected_index, const char* current_path);
+
+/**
+ * Starts a box art loader thread for tile index of the grid, showing
+ * rom_name in rom_path, from the listing at revision. The load ends with a
+ * GRID_EVENT_CODE event, carrying the tile if it has art and is still
+ * wanted (see grid_view.h).
+ *
+ * @return 1 if a loader was started
+ */
+int load_grid_tile(const char* rom_path, const char* rom_name, uint32_t revision, int index);
+
+/**
+ * Copies the rows of content around first_row, the top row on screen, into
+ * snapshot, along with the selection. Main thread only; the cost is a few
+ * pages of rows however long the listing is.
+ */
+void snapshot_listing(DirContent* content, int selected_index, int first_row,
+                      ListingSnapshot* snapshot);
+
+/**
+ * Draws the current page of a listing snapshot from the glyph atlas for
+ * font, with the selected row highlighted. Render thread only.
+ *
+ * @return 1 if the list is still scrolling or has rows left to draw, so
+ *         the frame should be drawn again
+ */
+int draw_listing(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing);
+
+/**
+ * Draws one not yet cached row of the pages either side of the current one
+ * into the list view's row slots, so turning to them doesn't rasterise
+ * anything. Render thread only, between frames.
+ *
+ * @return 1 if a row was drawn, 0 if both pages are ready
+ */
+int prerender_listing(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing);
+
+/**
+ * Draws a listing snapshot as a page of box art tiles with top_row at the
+ * top of the screen, labelled from the glyph atlas for font. Tiles whose
+ * art has not arrived are drawn as plain blocks. Render thread only.
+ */
+void draw_grid(SDL_Renderer *renderer, TTF_Font *font, const ListingSnapshot* listing, int top_row);
+
+/**
+ * Chooses how selections are highlighted. HIGHLIGHT_BAR is the default;
+ * "highlight = text" in romlauncher.ini selects HIGHLIGHT_TEXT.
+ */
+void set_highlight_mode(HighlightMode mode);
+HighlightMode get_highlight_mode(void);
+
+/**
+ * Fills the selection bar behind row, padded horizontally.
+ */
+void draw_selection_bar(SDL_Renderer *renderer, const SDL_Rect* row);
 
 #endif // BROWSER_H
@@ -0,0 +1,221 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <SDL.h>
+#include <SDL_thread.h>
+#include "collation.h"
+
+// Byte introducing an encoded number. Digits never appear in keys outside
+// a number, so this sorts numbers where ASCII digits used to sort.
+#define COLLATION_NUMBER '0'
+
+// Below this many items a partition is finished with insertion sort
+#define COLLATION_INSERTION_CUTOFF 16
+
+static const char* leading_articles[] = { "the ", "an ", "a " };
+
+static int is_digit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+static unsigned char fold_case(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+size_t collation_key_bound(size_t len) {
+    // A lone digit becomes marker, length and digit; the raw name and a
+    // separator follow as the tie-break
+    return 3 * len + 1 + len;
+}
+
+size_t collation_key(const char* name, size_t len, unsigned char* key) {
+    const unsigned char* text = (const unsigned char*)name;
+    size_t pos = 0;
+    size_t out = 0;
+
+    for (size_t a = 0; a < sizeof(leading_articles) / sizeof(leading_articles[0]); a++) {
+        size_t article_len = strlen(leading_articles[a]);
+        if (len > article_len && strncasecmp(name, leading_articles[a], article_len) == 0) {
+            pos = article_len;
+            break;
+        }
+    }
+
+    while (pos < len) {
+        if (!is_digit(text[pos])) {
+            key[out++] = fold_case(text[pos++]);
+            continue;
+        }
+
+        // Numbers encode as marker, significant digit count + 1, digits, so
+        // a longer number sorts after a shorter one and "007" equals "7"
+        while (pos < len && text[pos] == '0') pos++;
+        size_t start = pos;
+        while (pos < len && is_digit(text[pos])) pos++;
+        size_t digits = pos - start;
+
+        key[out++] = COLLATION_NUMBER;
+        key[out++] = digits < 254 ? (unsigned char)(digits + 1) : 255;
+        memcpy(key + out, text + start, digits);
+        out += digits;
+    }
+
+    // Every byte above is non-zero, so the separator sorts the tie-break last
+    key[out++] = '\0';
+    memcpy(key + out, name, len);
+    return out + len;
+}
+
+int collation_set_init(CollationSet* set, int count, size_t names_size) {
+    memset(set, 0, sizeof(CollationSet));
+    if (count <= 0) return 1;
+
+    set->items = malloc(count * sizeof(CollationItem));
+    set->keys = malloc(collation_key_bound(names_size) + count);
+    if (!set->items || !set->keys) {
+        collation_set_free(set);
+        return 0;
+    }
+    return 1;
+}
+
+void collation_set_add(CollationSet* set, const char* name, size_t len, uint32_t index) {
+    CollationItem* item = &set->items[set->count++];
+    item->key = set->keys + set->keys_size;
+    item->length = (uint32_t)collation_key(name, len, set->keys + set->keys_size);
+    item->index = index;
+    set->keys_size += item->length;
+}
+
+void collation_set_free(CollationSet* set) {
+    free(set->items);
+    free(set->keys);
+    memset(set, 0, sizeof(CollationSet));
+}
+
+static int compare_items(const CollationItem* a, const CollationItem* b, size_t depth) {
+    size_t a_len = a->length - depth;
+    size_t b_len = b->length - depth;
+    int result = memcmp(a->key + depth, b->key + depth, a_len < b_len ? a_len : b_len);
+    if (result != 0) return result;
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+// Key byte at depth, with the end of a key sorting before any byte
+static int key_byte(const CollationItem* item, size_t depth) {
+    return depth < item->length ? item->key[depth] : -1;
+}
+
+static void swap_items(CollationItem* a, CollationItem* b) {
+    CollationItem tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// Multikey quicksort (Bentley & Sedgewick): three-way partition on the byte
+// at depth, only descending a byte for the run that shares the pivot byte.
+// Every item passed in shares its first depth bytes.
+static void multikey_sort(CollationItem* items, int count, size_t depth) {
+    while (count > COLLATION_INSERTION_CUTOFF) {
+        swap_items(&items[0], &items[count / 2]);
+        int pivot = key_byte(&items[0], depth);
+
+        int lt = 0, i = 0, gt = count - 1;
+        while (i <= gt) {
+            int c = key_byte(&items[i], depth);
+            if (c < pivot) swap_items(&items[lt++], &items[i++]);
+            else if (c > pivot) swap_items(&items[i], &items[gt--]);
+            else i++;
+        }
+
+        multikey_sort(items, lt, depth);
+        if (pivot >= 0) multikey_sort(items + lt, gt - lt + 1, depth + 1);
+
+        items += gt + 1;
+        count -= gt + 1;
+    }
+
+    for (int i = 1; i < count; i++) {
+        CollationItem item = items[i];
+        int j = i;
+        while (j > 0 && compare_items(&items[j - 1], &item, depth) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = item;
+    }
+}
+
+typedef struct {
+    CollationItem* items;
+    int count;
+} SortChunk;
+
+static int sort_chunk_thread(void* data) {
+    SortChunk* chunk = (SortChunk*)data;
+    multikey_sort(chunk->items, chunk->count, 0);
+    return 0;
+}
+
+// Merges the sorted runs a and b into out
+static void merge_runs(const CollationItem* a, int a_count, const CollationItem* b, int b_count,
+                       CollationItem* out) {
+    int i = 0, j = 0, k = 0;
+    while (i < a_count && j < b_count) {
+        if (compare_items(&b[j], &a[i], 0) < 0) out[k++] = b[j++];
+        else out[k++] = a[i++];
+    }
+    while (i < a_count) out[k++] = a[i++];
+    while (j < b_count) out[k++] = b[j++];
+}
+
+void collation_set_sort(CollationSet* set) {
+    int count = set->count;
+    int threads = SDL_GetCPUCount();
+    if (threads > COLLATION_MAX_THREADS) threads = COLLATION_MAX_THREADS;
+
+    CollationItem* scratch = NULL;
+    if (count >= COLLATION_PARALLEL_THRESHOLD && threads > 1) {
+        scratch = malloc(count * sizeof(CollationItem));
+    }
+    if (!scratch) {
+        multikey_sort(set->items, count, 0);
+        return;
+    }
+
+    // Sort equal chunks side by side; the caller's thread takes the first
+    SortChunk chunks[COLLATION_MAX_THREADS];
+    SDL_Thread* workers[COLLATION_MAX_THREADS] = { NULL };
+    int chunk_size = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        int start = t * chunk_size;
+        chunks[t].items = set->items + start;
+        chunks[t].count = start + chunk_size <= count ? chunk_size : count - start;
+        if (chunks[t].count < 0) chunks[t].count = 0;
+        if (t > 0) {
+            workers[t] = SDL_CreateThread(sort_chunk_thread, "CollationSort", &chunks[t]);
+            if (!workers[t]) sort_chunk_thread(&chunks[t]);
+        }
+    }
+    sort_chunk_thread(&chunks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (workers[t]) SDL_WaitThread(workers[t], NULL);
+    }
+
+    // Merge neighbouring runs pairwise until one run is left
+    CollationItem* from = set->items;
+    CollationItem* to = scratch;
+    for (int width = chunk_size; width < count; width *= 2) {
+        for (int start = 0; start < count; start += 2 * width) {
+            int a_count = start + width <= count ? width : count - start;
+            int b_count = start + 2 * width <= count ? width : count - start - a_count;
+            merge_runs(from + start, a_count, from + start + a_count, b_count, to + start);
+        }
+        CollationItem* tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if (from != set->items) memcpy(set->items, from, count * sizeof(CollationItem));
+
+    free(scratch);
+}
@@ -0,0 +1,62 @@
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Listings at least this long are sorted on several threads
+#define COLLATION_PARALLEL_THRESHOLD 8192
+#define COLLATION_MAX_THREADS 4
+
+typedef struct {
+    const unsigned char *key;
+    uint32_t length;
+    uint32_t index;         // Caller's index of the entry this key belongs to
+} CollationItem;
+
+// A batch of collation keys built for one sort
+typedef struct {
+    CollationItem *items;
+    unsigned char *keys;
+    size_t keys_size;
+    int count;
+} CollationSet;
+
+/**
+ * Builds the collation key for a name into key, which must hold at least
+ * collation_key_bound(len) bytes. Keys compare with memcmp (shorter first
+ * on a common prefix) in browsing order: case-insensitive, numbers by
+ * value, leading "The", "A" and "An" ignored. The raw name is appended as
+ * a tie-break so distinct names never compare equal.
+ *
+ * @return The key length in bytes
+ */
+size_t collation_key(const char* name, size_t len, unsigned char* key);
+
+/**
+ * Returns the largest key collation_key() can produce for a name of len bytes.
+ */
+size_t collation_key_bound(size_t len);
+
+/**
+ * Allocates room for count keys built from names totalling names_size bytes.
+ *
+ * @return 1 on success, 0 if allocation fails
+ */
+int collation_set_init(CollationSet* set, int count, size_t names_size);
+
+/**
+ * Builds and appends the key for one name. Must not be called more times
+ * than the count given to collation_set_init().
+ */
+void collation_set_add(CollationSet* set, const char* name, size_t len, uint32_t index);
+
+/**
+ * Sorts the items by key with a multikey quicksort, split across threads
+ * for sets of at least COLLATION_PARALLEL_THRESHOLD items.
+ */
+void collation_set_sort(CollationSet* set);
+
+void collation_set_free(CollationSet* set);
+
+#endif // COLLATION_H
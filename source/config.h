@@ -8,10 +8,17 @@
 #define COLOR_BACKGROUND    (SDL_Color){200, 200, 200, 255}
 #define COLOR_TEXT         (SDL_Color){0, 0, 0, 255}
 #define COLOR_TEXT_HIGHLIGHT (SDL_Color){0, 0, 255, 255}
+#define COLOR_SELECTION_BAR (SDL_Color){160, 180, 235, 255}
 #define COLOR_TEXT_SELECTED (SDL_Color){0, 128, 0, 255}
 #define COLOR_TEXT_ERROR    (SDL_Color){255, 0, 0, 255}
 #define COLOR_STATUS_BAR (SDL_Color){220, 220, 220, 255}
 #define COLOR_STATUS_TEXT (SDL_Color){20, 20, 20, 255}
+#define COLOR_GRID_TILE (SDL_Color){170, 170, 170, 255}
+#define COLOR_ROW_PLACEHOLDER (SDL_Color){185, 185, 185, 255}
+#define COLOR_PERF_BACKGROUND (SDL_Color){0, 0, 0, 190}
+#define COLOR_PERF_TEXT (SDL_Color){255, 255, 255, 255}
+#define COLOR_PERF_BAR (SDL_Color){80, 210, 80, 255}
+#define COLOR_PERF_SLOW_BAR (SDL_Color){230, 70, 60, 255}
 #define MAX_PATH_LEN 1024
 
 #define SCREEN_W 1280
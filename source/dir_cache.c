@@ -0,0 +1,123 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "dir_cache.h"
+#include "config.h"
+#include "logging.h"
+
+typedef struct {
+    char path[MAX_PATH_LEN];
+    DirContent* content;
+    size_t bytes;
+    UT_hash_handle hh;
+} CachedListing;
+
+// uthash keeps insertion order, so the head is always the least recently used
+static CachedListing* cache = NULL;
+static int cached_entries = 0;
+static size_t cached_bytes = 0;
+
+static int64_t directory_mtime(const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) return 0;
+    return (int64_t)st.st_mtime;
+}
+
+int64_t dir_cache_stamp(const char* path) {
+    int64_t mtime = directory_mtime(path);
+    if (mtime >= (int64_t)time(NULL) - DIR_CACHE_MTIME_SLACK) return 0;
+    return mtime;
+}
+
+static int listing_entries(const DirContent* content) {
+    return content->dir_count + content->file_count;
+}
+
+static void remove_listing(CachedListing* item, int free_content) {
+    HASH_DEL(cache, item);
+    cached_entries -= listing_entries(item->content);
+    cached_bytes -= item->bytes;
+    if (free_content) free_dir_content(item->content);
+    free(item);
+}
+
+int dir_cache_accepts(const DirContent* content) {
+    return content && content->mtime != 0 &&
+           listing_entries(content) <= DIR_CACHE_MAX_ENTRIES &&
+           dir_content_bytes(content) <= DIR_CACHE_MAX_BYTES;
+}
+
+void dir_cache_put(const char* path, DirContent* content) {
+    if (!content) return;
+
+    if (!dir_cache_accepts(content) || strlen(path) >= MAX_PATH_LEN) {
+        free_dir_content(content);
+        return;
+    }
+
+    size_t bytes = dir_content_bytes(content);
+    int entries = listing_entries(content);
+
+    CachedListing* item;
+    HASH_FIND_STR(cache, path, item);
+    if (item) remove_listing(item, 1);
+
+    // Evict least recently used listings until the new one fits
+    while (cache && (HASH_COUNT(cache) >= DIR_CACHE_MAX_LISTINGS ||
+                     cached_entries + entries > DIR_CACHE_MAX_ENTRIES ||
+                     cached_bytes + bytes > DIR_CACHE_MAX_BYTES)) {
+        log_message(LOG_DEBUG, "Evicting cached listing: %s", cache->path);
+        remove_listing(cache, 1);
+    }
+
+    item = malloc(sizeof(CachedListing));
+    if (!item) {
+        free_dir_content(content);
+        return;
+    }
+
+    // A parked listing has no use for its box art
+    content->box_art = 0;
+    strcpy(item->path, path);
+    item->content = content;
+    item->bytes = bytes;
+    HASH_ADD_STR(cache, path, item);
+    cached_entries += entries;
+    cached_bytes += bytes;
+}
+
+DirContent* dir_cache_take(const char* path) {
+    CachedListing* item;
+    HASH_FIND_STR(cache, path, item);
+    if (!item) return NULL;
+
+    DirContent* content = item->content;
+    if (directory_mtime(path) != content->mtime) {
+        log_message(LOG_INFO, "Cached listing of %s is stale", path);
+        remove_listing(item, 1);
+        return NULL;
+    }
+
+    remove_listing(item, 0);
+    log_message(LOG_INFO, "Listing contents of %s from cache", path);
+    return content;
+}
+
+int dir_cache_contains(const char* path) {
+    CachedListing* item;
+    HASH_FIND_STR(cache, path, item);
+    return item != NULL;
+}
+
+int dir_cache_count(void) {
+    return HASH_COUNT(cache);
+}
+
+size_t dir_cache_bytes(void) {
+    return cached_bytes;
+}
+
+void dir_cache_clear(void) {
+    while (cache) remove_listing(cache, 1);
+}
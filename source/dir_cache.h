@@ -0,0 +1,66 @@
+#ifndef DIR_CACHE_H
+#define DIR_CACHE_H
+
+#include <stdint.h>
+#include "dir_content.h"
+
+/**
+ * LRU cache of recently visited directory listings, keyed by absolute path.
+ *
+ * Listings are parked here when the browser leaves a directory and taken
+ * back when it returns, so moving between a folder and its subfolders
+ * costs no I/O. A listing is only served while the directory's mtime still
+ * matches the one recorded when it was read.
+ */
+
+#define DIR_CACHE_MAX_LISTINGS 8
+#define DIR_CACHE_MAX_ENTRIES  20000
+#define DIR_CACHE_MAX_BYTES    (4 * 1024 * 1024)
+
+// Directories modified this recently (seconds) are not stamped, since a
+// change within the filesystem's timestamp granularity would go unseen
+#define DIR_CACHE_MTIME_SLACK 2
+
+/**
+ * Returns the mtime to record for a listing of path that is about to be
+ * read, or 0 if the directory is missing or changed too recently to trust.
+ */
+int64_t dir_cache_stamp(const char* path);
+
+/**
+ * Returns 1 if dir_cache_put() would keep content rather than free it.
+ */
+int dir_cache_accepts(const DirContent* content);
+
+/**
+ * Hands a listing to the cache, which takes ownership of it. Listings
+ * without an mtime stamp, or too big for the cache, are freed instead.
+ * Box art is released since a parked listing is not drawn.
+ */
+void dir_cache_put(const char* path, DirContent* content);
+
+/**
+ * Removes and returns the cached listing for path, or NULL if there is
+ * none or the directory has changed since it was read.
+ */
+DirContent* dir_cache_take(const char* path);
+
+/**
+ * Returns 1 if a listing of path is cached, without checking it is fresh.
+ */
+int dir_cache_contains(const char* path);
+
+/**
+ * Returns the number of listings currently cached.
+ */
+int dir_cache_count(void);
+
+/**
+ * Returns the memory held by the cached listings, as counted against
+ * DIR_CACHE_MAX_BYTES.
+ */
+size_t dir_cache_bytes(void);
+
+void dir_cache_clear(void);
+
+#endif // DIR_CACHE_H
@@ -0,0 +1,379 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dir_content.h"
+#include "emulator_selection.h"
+#include "collation.h"
+#include "library.h"
+#include "dir_cache.h"
+#include "logging.h"
+
+#define DIR_CONTENT_MIN_CAPACITY 16
+
+DirContent* dir_content_create(void) {
+    DirContent* content = malloc(sizeof(DirContent));
+    if (!content) return NULL;
+
+    memset(content, 0, sizeof(DirContent));
+    return content;
+}
+
+// Resizes one parallel array, zeroing any new slots. A failed shrink keeps
+// the larger block, which is still big enough.
+static int resize_array(void **array, size_t item_size, int count, int new_capacity, int shrinking) {
+    void *resized = realloc(*array, new_capacity * item_size);
+    if (!resized) return shrinking;
+
+    if (new_capacity > count) {
+        memset((char*)resized + count * item_size, 0, (new_capacity - count) * item_size);
+    }
+    *array = resized;
+    return 1;
+}
+
+// Resizes one side (directories or files) of the entry storage. The parallel
+// arrays are resized independently; capacity only ever reports a size that
+// every one of them has, so a failure part-way is harmless.
+static int resize_entries(EntryTable *table, int *capacity, int count, int new_capacity) {
+    if (new_capacity == 0) {
+        free(table->name_offset);
+        free(table->display_length);
+        free(table->ext_offset);
+        free(table->system);
+        free(table->flags);
+        memset(table, 0, sizeof(EntryTable));
+        *capacity = 0;
+        return 1;
+    }
+
+    int shrinking = new_capacity < *capacity;
+
+    if (!resize_array((void**)&table->name_offset, sizeof(uint32_t), count, new_capacity, shrinking) ||
+        !resize_array((void**)&table->display_length, sizeof(uint16_t), count, new_capacity, shrinking) ||
+        !resize_array((void**)&table->ext_offset, sizeof(uint16_t), count, new_capacity, shrinking) ||
+        !resize_array((void**)&table->system, sizeof(uint8_t), count, new_capacity, shrinking) ||
+        !resize_array((void**)&table->flags, sizeof(uint8_t), count, new_capacity, shrinking)) {
+        return 0;
+    }
+
+    *capacity = new_capacity;
+    return 1;
+}
+
+static int grow_capacity(int capacity, int needed) {
+    int new_capacity = capacity ? capacity : DIR_CONTENT_MIN_CAPACITY;
+    while (new_capacity < needed) new_capacity *= 2;
+    return new_capacity;
+}
+
+int dir_content_reserve(DirContent* content, int dir_count, int file_count) {
+    if (!content) return 0;
+
+    if (dir_count > content->dir_capacity &&
+        !resize_entries(&content->dirs, &content->dir_capacity, content->dir_count,
+                        grow_capacity(content->dir_capacity, dir_count))) {
+        return 0;
+    }
+
+    if (file_count > content->file_capacity &&
+        !resize_entries(&content->files, &content->file_capacity, content->file_count,
+                        grow_capacity(content->file_capacity, file_count))) {
+        return 0;
+    }
+
+    return 1;
+}
+
+int dir_content_reserve_names(DirContent* content, size_t bytes) {
+    if (!content) return 0;
+    if (content->names_size + bytes <= content->names_capacity) return 1;
+    if (content->names_size + bytes > UINT32_MAX) return 0;
+
+    size_t capacity = content->names_capacity ? content->names_capacity : 1024;
+    while (capacity < content->names_size + bytes) capacity *= 2;
+
+    char* names = realloc(content->names, capacity);
+    if (!names) return 0;
+
+    content->names = names;
+    content->names_capacity = capacity;
+    return 1;
+}
+
+// Copies a name into the arena and fills in row i of table
+static int append_entry(DirContent* content, EntryTable* table, int i,
+                        const char* name, size_t len, uint8_t flags) {
+    if (len > UINT16_MAX) return 0;
+    if (!dir_content_reserve_names(content, len + 1)) return 0;
+
+    char* copy = content->names + content->names_size;
+    memcpy(copy, name, len);
+    copy[len] = '\0';
+
+    // Display names drop everything from the last dot on
+    const char* dot = strrchr(copy, '.');
+    uint16_t display_length = dot ? (uint16_t)(dot - copy) : (uint16_t)len;
+
+    table->name_offset[i] = (uint32_t)content->names_size;
+    table->display_length[i] = display_length;
+    table->ext_offset[i] = dot ? display_length + 1 : (uint16_t)len;
+    table->system[i] = (flags & ENTRY_IS_DIR) || !dot ?
+        SYSTEM_UNKNOWN : (uint8_t)derive_system_from_extension(dot + 1);
+    table->flags[i] = flags;
+
+    content->names_size += len + 1;
+    content->revision = 0;
+    return 1;
+}
+
+int dir_content_add_dir(DirContent* content, const char* name, size_t len) {
+    if (!dir_content_reserve(content, content->dir_count + 1, 0)) return 0;
+    if (!append_entry(content, &content->dirs, content->dir_count, name, len, ENTRY_IS_DIR)) return 0;
+    content->dir_count++;
+    return 1;
+}
+
+int dir_content_add_file(DirContent* content, const char* name, size_t len) {
+    if (!dir_content_reserve(content, 0, content->file_count + 1)) return 0;
+    if (!append_entry(content, &content->files, content->file_count, name, len, 0)) return 0;
+    content->file_count++;
+    return 1;
+}
+
+int dir_content_append(DirContent* content, const DirContent* other) {
+    if (!dir_content_reserve(content, content->dir_count + other->dir_count,
+                             content->file_count + other->file_count) ||
+        !dir_content_reserve_names(content, other->names_size)) {
+        return 0;
+    }
+
+    for (int i = 0; i < other->dir_count; i++) {
+        const char* name = dir_content_dir_name(other, i);
+        if (!dir_content_add_dir(content, name, strlen(name))) return 0;
+    }
+    for (int i = 0; i < other->file_count; i++) {
+        const char* name = dir_content_file_name(other, i);
+        if (!dir_content_add_file(content, name, strlen(name))) return 0;
+    }
+    return 1;
+}
+
+const char* dir_content_dir_name(const DirContent* content, int i) {
+    return content->names + content->dirs.name_offset[i];
+}
+
+const char* dir_content_file_name(const DirContent* content, int i) {
+    return content->names + content->files.name_offset[i];
+}
+
+const char* dir_content_file_extension(const DirContent* content, int i) {
+    return dir_content_file_name(content, i) + content->files.ext_offset[i];
+}
+
+void dir_content_set_favorite(DirContent* content, int i, int favorite) {
+    if (favorite) content->files.flags[i] |= ENTRY_FAVORITE;
+    else content->files.flags[i] &= ~ENTRY_FAVORITE;
+    content->revision = 0;
+}
+
+uint32_t dir_content_revision(DirContent* content) {
+    static uint32_t last_revision = 0;
+    if (content->revision == 0) {
+        if (++last_revision == 0) last_revision = 1;
+        content->revision = last_revision;
+    }
+    return content->revision;
+}
+
+void dir_content_touch(DirContent* content) {
+    content->revision = 0;
+}
+
+// Reorders one column so that row i takes the old row order[i]
+static void permute_column(void* column, size_t item_size, const int* order, int count, char* scratch) {
+    for (int i = 0; i < count; i++) {
+        memcpy(scratch + i * item_size, (char*)column + order[i] * item_size, item_size);
+    }
+    memcpy(column, scratch, count * item_size);
+}
+
+static int sort_table(DirContent* content, EntryTable* table, int count) {
+    if (count < 2) return 1;
+
+    CollationSet set;
+    int* order = malloc(count * sizeof(int));
+    char* scratch = malloc(count * sizeof(uint32_t));
+    if (!order || !scratch || !collation_set_init(&set, count, content->names_size)) {
+        free(order);
+        free(scratch);
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const char* name = content->names + table->name_offset[i];
+        collation_set_add(&set, name, strlen(name), i);
+    }
+    collation_set_sort(&set);
+    for (int i = 0; i < count; i++) order[i] = set.items[i].index;
+    collation_set_free(&set);
+
+    permute_column(table->name_offset, sizeof(uint32_t), order, count, scratch);
+    permute_column(table->display_length, sizeof(uint16_t), order, count, scratch);
+    permute_column(table->ext_offset, sizeof(uint16_t), order, count, scratch);
+    permute_column(table->system, sizeof(uint8_t), order, count, scratch);
+    permute_column(table->flags, sizeof(uint8_t), order, count, scratch);
+
+    free(order);
+    free(scratch);
+    return 1;
+}
+
+int dir_content_sort(DirContent* content) {
+    if (!content) return 0;
+    content->revision = 0;
+    return sort_table(content, &content->dirs, content->dir_count) &&
+           sort_table(content, &content->files, content->file_count);
+}
+
+void dir_content_clear(DirContent* content) {
+    if (!content) return;
+
+    content->box_art = 0;
+    content->dir_count = 0;
+    content->file_count = 0;
+    content->names_size = 0;
+    content->mtime = 0;
+    content->revision = 0;
+}
+
+// Fills an empty listing from the library index entries for path
+static int fill_from_library(DirContent* content, const LibrarySlice* slice) {
+    int total = slice->dir_count + slice->file_count;
+    size_t names_size = 0;
+    for (int i = 0; i < total; i++) {
+        names_size += slice->entries[i].name_length + 1;
+    }
+
+    if (!dir_content_reserve(content, slice->dir_count, slice->file_count) ||
+        !dir_content_reserve_names(content, names_size)) {
+        return 0;
+    }
+
+    // Everything is reserved up front, so these appends cannot fail
+    for (int i = 0; i < total; i++) {
+        const char* name = library_entry_name(slice, i);
+        size_t len = slice->entries[i].name_length;
+
+        if (i < slice->dir_count) {
+            dir_content_add_dir(content, name, len);
+        } else {
+            dir_content_add_file(content, name, len);
+        }
+    }
+    return 1;
+}
+
+int dir_content_refill(DirContent* content, const char* path) {
+    if (!content || !path) return 0;
+
+    // Serve the listing from the library index when the directory is known;
+    // its entries are already split into directories and files and sorted.
+    LibrarySlice slice;
+    if (library_lookup(path, &slice)) {
+        log_message(LOG_INFO, "Listing contents of %s from library index", path);
+        dir_content_clear(content);
+        content->mtime = dir_cache_stamp(path);
+        if (!fill_from_library(content, &slice)) {
+            log_message(LOG_ERROR, "Out of memory listing %s", path);
+        }
+        return 1;
+    }
+
+    DIR* dir = opendir(path);
+    if (dir == NULL) {
+        log_message(LOG_INFO, "Failed to open directory: %s", path);
+        return 0;
+    }
+
+    log_message(LOG_INFO, "Listing contents of: %s", path);
+    dir_content_clear(content);
+    content->mtime = dir_cache_stamp(path);
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        size_t len = strlen(entry->d_name);
+        int added = entry->d_type == DT_DIR ?
+            dir_content_add_dir(content, entry->d_name, len) :
+            dir_content_add_file(content, entry->d_name, len);
+        if (!added) {
+            log_message(LOG_ERROR, "Out of memory listing %s", path);
+            break;
+        }
+    }
+    closedir(dir);
+
+    if (!dir_content_sort(content)) {
+        log_message(LOG_ERROR, "Out of memory sorting %s", path);
+    }
+    return 1;
+}
+
+void dir_content_trim(DirContent* content) {
+    if (!content) return;
+
+    // A failed shrink just leaves the larger arrays in place
+    if (content->dir_capacity > content->dir_count) {
+        resize_entries(&content->dirs, &content->dir_capacity, content->dir_count, content->dir_count);
+    }
+    if (content->file_capacity > content->file_count) {
+        resize_entries(&content->files, &content->file_capacity, content->file_count, content->file_count);
+    }
+    if (content->names_capacity > content->names_size && content->names_size > 0) {
+        char* names = realloc(content->names, content->names_size);
+        if (names) {
+            content->names = names;
+            content->names_capacity = content->names_size;
+        }
+    }
+}
+
+size_t dir_content_bytes(const DirContent* content) {
+    size_t per_entry = sizeof(uint32_t) + 2 * sizeof(uint16_t) + 2 * sizeof(uint8_t);
+    return sizeof(DirContent) + content->names_capacity +
+           (size_t)(content->dir_capacity + content->file_capacity) * per_entry;
+}
+
+void free_dir_content(DirContent* content) {
+    if (!content) return;
+
+    // Free favorite groups structure if this was a favorites view
+    if (content->is_favorites_view && content->groups) {
+        FavoriteGroup* group = content->groups;
+        while (group) {
+            FavoriteEntry* entry = group->entries;
+            while (entry) {
+                FavoriteEntry* next_entry = entry->next;
+                if (entry->path) free(entry->path);
+                if (entry->display_name) free(entry->display_name);
+                free(entry);
+                entry = next_entry;
+            }
+            FavoriteGroup* next_group = group->next;
+            if (group->group_name) free(group->group_name);
+            free(group);
+            group = next_group;
+        }
+        content->groups = NULL;
+    }
+
+    // Free arrays; the names all live in the one arena
+    if (content->names) free(content->names);
+    resize_entries(&content->dirs, &content->dir_capacity, 0, 0);
+    resize_entries(&content->files, &content->file_capacity, 0, 0);
+
+    free(content);
+}
@@ -0,0 +1,161 @@
+#ifndef DIR_CONTENT_H
+#define DIR_CONTENT_H
+
+#include <stdint.h>
+#include <SDL.h>
+
+typedef struct FavoriteEntry {
+    char *path;
+    char *display_name;
+    struct FavoriteEntry *next;
+} FavoriteEntry;
+
+typedef struct FavoriteGroup {
+    char *group_name;
+    FavoriteEntry *entries;
+    int entry_count;
+    struct FavoriteGroup *next;
+} FavoriteGroup;
+
+// Entry flag bits
+#define ENTRY_IS_DIR   0x01
+#define ENTRY_FAVORITE 0x02
+#define ENTRY_HEADER   0x04     // Group heading in the favorites view
+
+// Structure-of-arrays metadata for one side (directories or files) of a
+// listing. Everything is derived once when an entry is added so paging and
+// launching only touch these compact arrays.
+typedef struct {
+    uint32_t *name_offset;      // Start of the name in the DirContent's arena
+    uint16_t *display_length;   // Name length without the extension
+    uint16_t *ext_offset;       // Start of the extension within the name
+    uint8_t *system;            // SystemType derived from the extension
+    uint8_t *flags;             // ENTRY_* bits
+} EntryTable;
+
+typedef struct {
+    char *names;            // Arena holding every entry name, NUL-terminated
+    size_t names_size;
+    size_t names_capacity;
+    EntryTable dirs;
+    EntryTable files;
+    int dir_count;
+    int file_count;
+    int dir_capacity;       // Allocated slots in dirs
+    int file_capacity;      // Allocated slots in files
+    FavoriteGroup *groups;  // Used only for favorites view
+    int is_favorites_view;
+    int is_history_view;    // Flag for history view
+    int box_art;            // Request id of the box art shown with it, 0 for none
+    int64_t mtime;          // Directory mtime the listing was read at, 0 if unknown
+    uint32_t revision;      // See dir_content_revision(), 0 once changed
+} DirContent;
+
+/**
+ * Allocates an empty DirContent with no entry storage.
+ *
+ * @return A zeroed DirContent, or NULL if allocation fails
+ */
+DirContent* dir_content_create(void);
+
+/**
+ * Ensures there is room for at least dir_count directories and file_count
+ * files. Storage grows geometrically so repeated appends stay amortised O(1).
+ *
+ * @return 1 on success, 0 if allocation fails (existing entries are kept)
+ */
+int dir_content_reserve(DirContent* content, int dir_count, int file_count);
+
+/**
+ * Ensures the name arena can take at least bytes more bytes of names
+ * (including their terminating NULs) without reallocating.
+ *
+ * @return 1 on success, 0 if allocation fails
+ */
+int dir_content_reserve_names(DirContent* content, size_t bytes);
+
+/**
+ * Appends a directory or file entry, copying len bytes of name into the
+ * name arena.
+ *
+ * @return 1 on success, 0 if allocation fails
+ */
+int dir_content_add_dir(DirContent* content, const char* name, size_t len);
+int dir_content_add_file(DirContent* content, const char* name, size_t len);
+
+/**
+ * Appends copies of every directory and file in other.
+ *
+ * @return 1 on success, 0 if allocation fails part-way
+ */
+int dir_content_append(DirContent* content, const DirContent* other);
+
+/**
+ * Returns the NUL-terminated name of directory or file i. The pointer is
+ * only valid until the next entry is added.
+ */
+const char* dir_content_dir_name(const DirContent* content, int i);
+const char* dir_content_file_name(const DirContent* content, int i);
+
+/**
+ * Returns the extension of file i (without the dot), or "" if it has none.
+ */
+const char* dir_content_file_extension(const DirContent* content, int i);
+
+/**
+ * Sets or clears the favorite bit of file i. The revision changes since
+ * the favorite marker changes the label.
+ */
+void dir_content_set_favorite(DirContent* content, int i, int favorite);
+
+/**
+ * Returns a number identifying the listing as it would currently draw:
+ * unique across listings, and replaced with a new one after any change to
+ * its entries or, via dir_content_touch(), their layout. Caches of drawn
+ * rows key on it. Main thread only.
+ */
+uint32_t dir_content_revision(DirContent* content);
+
+/**
+ * Marks the listing changed, for edits made to it directly such as moving
+ * its rows.
+ */
+void dir_content_touch(DirContent* content);
+
+/**
+ * Sorts directories and files into browsing order (see collation.h),
+ * keeping every column of the entry tables in step.
+ *
+ * @return 1 on success, 0 if allocation fails (order is left unchanged)
+ */
+int dir_content_sort(DirContent* content);
+
+/**
+ * Empties the listing but keeps its entry storage and name arena for reuse.
+ * Its box art stops showing.
+ */
+void dir_content_clear(DirContent* content);
+
+/**
+ * Replaces the entries with the listing of path, reusing the existing
+ * buffers and only growing them when the new listing does not fit. Entries
+ * come from the library index when path is known there, otherwise from
+ * readdir and are sorted.
+ *
+ * @return 1 on success, 0 if path cannot be listed (content is left as it was)
+ */
+int dir_content_refill(DirContent* content, const char* path);
+
+/**
+ * Shrinks the entry storage and name arena to what is actually used.
+ */
+void dir_content_trim(DirContent* content);
+
+/**
+ * Returns the heap memory held by the listing's entry storage and names.
+ */
+size_t dir_content_bytes(const DirContent* content);
+
+void free_dir_content(DirContent* content);
+
+#endif // DIR_CONTENT_H
@@ -56,10 +56,6 @@ static const EmulatorConfig RETROARCH_FLYCAST = {
     .core_name = "flycast"
 };
 
-// Forward declarations
-SystemType derive_system_from_extension(const char *extension);
-const EmulatorConfig* derive_emulator_for_system(SystemType system);
-
 /**
  * Determines the system type based on the file path
  *
@@ -46,6 +46,22 @@ typedef struct {
  */
 SystemType derive_system_from_path(const char *path);
 
+/**
+ * Determines the system type based on the file extension
+ *
+ * @param extension The file extension (without the dot)
+ * @return The identified system type
+ */
+SystemType derive_system_from_extension(const char *extension);
+
+/**
+ * Determines which emulator to use based on the system type
+ *
+ * @param system The system type
+ * @return Pointer to a static EmulatorConfig structure (do not free)
+ */
+const EmulatorConfig* derive_emulator_for_system(SystemType system);
+
 /**
  * Determines which emulator to use based on the file path
  *
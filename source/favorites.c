@@ -161,7 +161,7 @@ int is_group_header(const char* text) {
 }
 
 int find_next_rom(DirContent* content, int current_index, int direction) {
-    if (!content || !content->files || content->file_count == 0) {
+    if (!content || content->file_count == 0) {
         return current_index;
     }
 
@@ -178,7 +178,7 @@ int find_next_rom(DirContent* content, int current_index, int direction) {
         }
 
         // Found a non-header entry
-        if (!is_group_header(content->files[index])) {
+        if (!is_group_header(dir_content_file_name(content, index))) {
             return index;
         }
 
@@ -267,21 +267,13 @@ DirContent* list_favorites(void) {
     // If no favorites exist, create a single entry with the help message
     if (!groups) {
         log_message(LOG_INFO, "No favorite groups created, showing help message");
-        content->files = calloc(1, sizeof(char*));
-        content->file_textures = calloc(1, sizeof(SDL_Texture*));
-        content->file_rects = calloc(1, sizeof(SDL_Rect));
-
-        if (!content->files || !content->file_textures || !content->file_rects) {
+        const char* message = "Use the X button to add favorites!";
+        if (!dir_content_add_file(content, message, strlen(message))) {
             free_dir_content(content);
             return NULL;
         }
 
-        content->files[0] = strdup("Use the X button to add favorites!");
-        content->file_count = 1;
-
-        // Center the message on screen
-        content->file_rects[0].x = 400; // Will be adjusted when rendered
-        content->file_rects[0].y = 300; // Will be adjusted when rendered
+        // draw_listing() centers the message on screen
         return content;
     }
 
@@ -292,11 +284,7 @@ DirContent* list_favorites(void) {
     }
 
     // Allocate arrays
-    content->files = calloc(total_entries, sizeof(char*));
-    content->file_textures = calloc(total_entries, sizeof(SDL_Texture*));
-    content->file_rects = calloc(total_entries, sizeof(SDL_Rect));
-
-    if (!content->files || !content->file_textures || !content->file_rects) {
+    if (!dir_content_reserve(content, 0, total_entries)) {
         // Handle allocation failure
         free_dir_content(content);
         return NULL;
@@ -345,22 +333,19 @@ DirContent* list_favorites(void) {
         FavoriteGroup* group = group_array[i];
         // Add group name
         char group_display[MAX_PATH_LEN];
-        snprintf(group_display, sizeof(group_display), "[%s]", group->group_name);
-        content->files[idx] = strdup(group_display);
-        content->file_rects[idx].x = 30;
-        content->file_rects[idx].y = 50 + ((idx % ENTRIES_PER_PAGE) * 40);
+        int len = snprintf(group_display, sizeof(group_display), "[%s]", group->group_name);
+        if (len >= (int)sizeof(group_display)) len = sizeof(group_display) - 1;
+        if (len < 0 || !dir_content_add_file(content, group_display, len)) break;
+        content->files.flags[idx] |= ENTRY_HEADER;
         idx++;
 
         // Add entries
         for (FavoriteEntry* entry = group->entries; entry != NULL; entry = entry->next) {
-            content->files[idx] = strdup(entry->display_name);
-            content->file_rects[idx].x = 50;
-            content->file_rects[idx].y = 50 + ((idx % ENTRIES_PER_PAGE) * 40);
+            if (!dir_content_add_file(content, entry->display_name, strlen(entry->display_name))) break;
             idx++;
         }
     }
 
-    content->file_count = idx;
     // Rebuild the groups linked list in sorted order using the sorted group_array
     if (group_idx > 0) {
         for (int i = 0; i < group_idx - 1; i++) {
@@ -385,7 +370,8 @@ void toggle_current_favorite(DirContent* content, int selected_index, const char
     if (file_index >= content->file_count) return;
 
     char full_path[MAX_PATH_LEN];
-    snprintf(full_path, MAX_PATH_LEN, "%s/%s", current_path, content->files[file_index]);
+    snprintf(full_path, MAX_PATH_LEN, "%s/%s", current_path, dir_content_file_name(content, file_index));
 
     toggle_favorite(full_path);
+    dir_content_set_favorite(content, file_index, is_favorite(full_path));
 }
@@ -0,0 +1,100 @@
+#include "frame.h"
+
+static Frame frames[3];
+static Frame* filling = &frames[0];
+static Frame* published = &frames[1];
+static Frame* drawing = &frames[2];
+static int fresh = 0;           // published has not been taken yet
+static int woken = 0;
+
+// Frames published so far, and the count as of the frame taken for drawing
+// and the one last drawn
+static Uint32 published_count = 0;
+static Uint32 taken_count = 0;
+static Uint32 drawn_count = 0;
+
+static SDL_mutex* lock = NULL;
+static SDL_cond* changed = NULL;
+static SDL_cond* drawn = NULL;
+
+int frame_init(void) {
+    lock = SDL_CreateMutex();
+    changed = SDL_CreateCond();
+    drawn = SDL_CreateCond();
+    fresh = 0;
+    woken = 0;
+    published_count = taken_count = drawn_count = 0;
+    return lock && changed && drawn;
+}
+
+Frame* frame_begin(void) {
+    return filling;
+}
+
+void frame_publish(void) {
+    SDL_LockMutex(lock);
+    Frame* spare = published;
+    published = filling;
+    filling = spare;
+    fresh = 1;
+    published_count++;
+    SDL_CondSignal(changed);
+    SDL_UnlockMutex(lock);
+}
+
+const Frame* frame_take(void) {
+    Frame* taken = NULL;
+    SDL_LockMutex(lock);
+    if (fresh) {
+        Frame* spare = drawing;
+        drawing = published;
+        published = spare;
+        fresh = 0;
+        taken_count = published_count;
+        taken = drawing;
+    }
+    SDL_UnlockMutex(lock);
+    return taken;
+}
+
+int frame_wait(Uint32 timeout) {
+    SDL_LockMutex(lock);
+    if (!fresh && !woken) SDL_CondWaitTimeout(changed, lock, timeout);
+    int waiting = fresh;
+    woken = 0;
+    SDL_UnlockMutex(lock);
+    return waiting;
+}
+
+void frame_drawn(void) {
+    SDL_LockMutex(lock);
+    drawn_count = taken_count;
+    SDL_CondSignal(drawn);
+    SDL_UnlockMutex(lock);
+}
+
+int frame_wait_drawn(Uint32 timeout) {
+    SDL_LockMutex(lock);
+    while (drawn_count != published_count) {
+        if (SDL_CondWaitTimeout(drawn, lock, timeout) == SDL_MUTEX_TIMEDOUT) break;
+    }
+    int done = drawn_count == published_count;
+    SDL_UnlockMutex(lock);
+    return done;
+}
+
+void frame_wake(void) {
+    SDL_LockMutex(lock);
+    woken = 1;
+    SDL_CondSignal(changed);
+    SDL_UnlockMutex(lock);
+}
+
+void frame_shutdown(void) {
+    if (changed) SDL_DestroyCond(changed);
+    if (drawn) SDL_DestroyCond(drawn);
+    if (lock) SDL_DestroyMutex(lock);
+    changed = NULL;
+    drawn = NULL;
+    lock = NULL;
+}
@@ -0,0 +1,97 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <SDL.h>
+#include "browser.h"
+
+/**
+ * Frame snapshots passed from the main thread to the render thread.
+ *
+ * The main thread describes what should be on screen as a Frame and
+ * publishes it; the render thread takes the newest published frame and
+ * draws it. Besides the frame being filled and the one being drawn there is
+ * a third, the last one published, so publishing and taking only swap
+ * pointers under a lock: neither thread waits for the other to finish with
+ * a frame, and frames published faster than they are drawn are replaced by
+ * newer ones rather than queued.
+ */
+
+#define FRAME_MESSAGE_MAX 256
+
+typedef enum {
+    FRAME_VIEW_LISTING,
+    FRAME_VIEW_GRID,
+    FRAME_VIEW_MENU,
+    FRAME_VIEW_SCRAPING
+} FrameView;
+
+typedef struct {
+    FrameView view;
+    ListingSnapshot listing;
+    int menu_selection;
+    int grid_top_row;                       // Top row of tiles in FRAME_VIEW_GRID
+    char notification[FRAME_MESSAGE_MAX];   // Shown over the dimmed screen, "" for none
+    int box_art;                            // Request id of the box art to show, 0 for none
+} Frame;
+
+/**
+ * Creates the locks the frames are exchanged under.
+ *
+ * @return 1 on success, 0 on failure
+ */
+int frame_init(void);
+
+/**
+ * Returns the frame for the main thread to fill. It is never the one the
+ * render thread is drawing.
+ */
+Frame* frame_begin(void);
+
+/**
+ * Publishes the frame returned by frame_begin(), replacing any published
+ * frame the render thread has not taken yet.
+ */
+void frame_publish(void);
+
+/**
+ * Takes the newest published frame for drawing. It stays valid and
+ * unchanged until the next call that returns a frame.
+ *
+ * @return The frame, or NULL if nothing was published since the last take
+ */
+const Frame* frame_take(void);
+
+/**
+ * Sleeps until a frame is published, frame_wake() is called or timeout ms
+ * pass.
+ *
+ * @return 1 if a frame is waiting to be taken
+ */
+int frame_wait(Uint32 timeout);
+
+/**
+ * Records that the frame last taken has been drawn and presented. Render
+ * thread only.
+ */
+void frame_drawn(void);
+
+/**
+ * Sleeps until the newest published frame has been drawn, or until timeout
+ * ms pass without a frame being drawn. Lets a headless benchmark time the
+ * drawing along with the main loop.
+ *
+ * @return 1 if every published frame has been drawn
+ */
+int frame_wait_drawn(Uint32 timeout);
+
+/**
+ * Wakes the render thread from frame_wait().
+ */
+void frame_wake(void);
+
+/**
+ * Destroys the locks. Only once the render thread has exited.
+ */
+void frame_shutdown(void);
+
+#endif // FRAME_H
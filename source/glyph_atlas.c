@@ -0,0 +1,235 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "glyph_atlas.h"
+#include "logging.h"
+#include "perf.h"
+#include "sprite_batch.h"
+
+// Latin-1 bytes below this are control characters and have no glyph
+#define GLYPH_FIRST 32
+#define GLYPH_COUNT (256 - GLYPH_FIRST)
+
+// Kerning is cached for printable ASCII pairs, which covers nearly every
+// file name; anything else is asked of the font each time
+#define KERNING_COUNT   (127 - GLYPH_FIRST)
+#define KERNING_UNKNOWN INT8_MIN
+
+// Gap left between glyphs so filtering never bleeds a neighbour in
+#define GLYPH_PADDING 1
+
+typedef struct {
+    SDL_Rect src;       // Position in the atlas texture, empty if not drawable
+    int16_t advance;
+    uint8_t loaded;
+} AtlasGlyph;
+
+struct GlyphAtlas {
+    TTF_Font* font;
+    SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    int height;
+    int shelf_x;        // Next free column on the current shelf
+    int shelf_y;        // Top of the current shelf
+    int shelf_height;   // Tallest glyph on the current shelf
+    int full;
+    AtlasGlyph glyphs[GLYPH_COUNT];
+    int8_t kerning[KERNING_COUNT][KERNING_COUNT];
+};
+
+static GlyphAtlas* atlases[GLYPH_ATLAS_MAX_FONTS];
+
+static GlyphAtlas* create_atlas(SDL_Renderer* renderer, TTF_Font* font) {
+    GlyphAtlas* atlas = malloc(sizeof(GlyphAtlas));
+    if (!atlas) return NULL;
+
+    memset(atlas, 0, sizeof(GlyphAtlas));
+    memset(atlas->kerning, KERNING_UNKNOWN, sizeof(atlas->kerning));
+    atlas->font = font;
+    atlas->renderer = renderer;
+    atlas->height = TTF_FontHeight(font);
+    atlas->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                       GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE);
+    if (!atlas->texture) {
+        log_message(LOG_ERROR, "Couldn't create glyph atlas texture: %s", SDL_GetError());
+        free(atlas);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    perf_count(PERF_TEXTURES_ALIVE, 1);
+    return atlas;
+}
+
+GlyphAtlas* glyph_atlas_get(SDL_Renderer* renderer, TTF_Font* font) {
+    if (!renderer || !font) return NULL;
+
+    int free_slot = -1;
+    for (int i = 0; i < GLYPH_ATLAS_MAX_FONTS; i++) {
+        if (atlases[i] && atlases[i]->font == font && atlases[i]->renderer == renderer) {
+            return atlases[i];
+        }
+        if (!atlases[i] && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) {
+        log_message(LOG_ERROR, "No glyph atlas slot left for another font");
+        return NULL;
+    }
+
+    atlases[free_slot] = create_atlas(renderer, font);
+    return atlases[free_slot];
+}
+
+int glyph_atlas_height(const GlyphAtlas* atlas) {
+    return atlas ? atlas->height : 0;
+}
+
+// Copies a rasterised glyph into the next free spot on the current shelf,
+// starting a new shelf when the row is used up
+static int pack_glyph(GlyphAtlas* atlas, SDL_Surface* surface, SDL_Rect* src) {
+    if (atlas->shelf_x + surface->w > GLYPH_ATLAS_SIZE) {
+        atlas->shelf_x = 0;
+        atlas->shelf_y += atlas->shelf_height + GLYPH_PADDING;
+        atlas->shelf_height = 0;
+    }
+    if (surface->w > GLYPH_ATLAS_SIZE || atlas->shelf_y + surface->h > GLYPH_ATLAS_SIZE) {
+        if (!atlas->full) log_message(LOG_ERROR, "Glyph atlas is full");
+        atlas->full = 1;
+        return 0;
+    }
+
+    SDL_Rect dst = { atlas->shelf_x, atlas->shelf_y, surface->w, surface->h };
+    if (SDL_UpdateTexture(atlas->texture, &dst, surface->pixels, surface->pitch) != 0) {
+        log_message(LOG_ERROR, "Couldn't upload glyph: %s", SDL_GetError());
+        return 0;
+    }
+
+    *src = dst;
+    atlas->shelf_x += surface->w + GLYPH_PADDING;
+    if (surface->h > atlas->shelf_height) atlas->shelf_height = surface->h;
+    return 1;
+}
+
+static AtlasGlyph* load_glyph(GlyphAtlas* atlas, unsigned char c) {
+    AtlasGlyph* glyph = &atlas->glyphs[c - GLYPH_FIRST];
+    if (glyph->loaded) return glyph;
+    glyph->loaded = 1;
+
+    int minx, maxx, miny, maxy, advance;
+    if (TTF_GlyphMetrics(atlas->font, c, &minx, &maxx, &miny, &maxy, &advance) != 0) return glyph;
+    glyph->advance = (int16_t)advance;
+
+    // Glyphs are rasterised white and tinted when drawn
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(atlas->font, c, white);
+    if (!surface) return glyph;   // Blank glyphs such as space have no bitmap
+    perf_count(PERF_TEXT_RASTERS, 1);
+
+    SDL_Surface* pixels = surface;
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        pixels = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    }
+    if (pixels) {
+        pack_glyph(atlas, pixels, &glyph->src);
+        if (pixels != surface) SDL_FreeSurface(pixels);
+    }
+    SDL_FreeSurface(surface);
+    return glyph;
+}
+
+static int kerning(GlyphAtlas* atlas, unsigned char prev, unsigned char c) {
+    if (prev >= 127 || c >= 127) {
+        return TTF_GetFontKerningSizeGlyphs(atlas->font, prev, c);
+    }
+
+    int8_t* cached = &atlas->kerning[prev - GLYPH_FIRST][c - GLYPH_FIRST];
+    if (*cached == KERNING_UNKNOWN) {
+        int k = TTF_GetFontKerningSizeGlyphs(atlas->font, prev, c);
+        *cached = (int8_t)(k < INT8_MIN + 1 ? INT8_MIN + 1 : (k > INT8_MAX ? INT8_MAX : k));
+    }
+    return *cached;
+}
+
+int glyph_atlas_measure(GlyphAtlas* atlas, const char* text, size_t len) {
+    if (!atlas || !text) return 0;
+
+    int width = 0;
+    unsigned char prev = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c < GLYPH_FIRST) continue;
+        if (prev) width += kerning(atlas, prev, c);
+        width += load_glyph(atlas, c)->advance;
+        prev = c;
+    }
+    return width;
+}
+
+size_t glyph_atlas_fit(GlyphAtlas* atlas, const char* text, size_t len, int max_width, int* width,
+                       int* prefix) {
+    int fitted = 0;
+    size_t i = 0;
+    if (atlas && text) {
+        unsigned char prev = 0;
+        for (; i < len; i++) {
+            unsigned char c = (unsigned char)text[i];
+            if (c >= GLYPH_FIRST) {
+                int x = fitted + (prev ? kerning(atlas, prev, c) : 0) + load_glyph(atlas, c)->advance;
+                if (x > max_width) break;
+                fitted = x;
+                prev = c;
+            }
+            if (prefix) prefix[i] = fitted;
+        }
+    }
+    if (width) *width = fitted;
+    return i;
+}
+
+size_t glyph_atlas_refit(const int* prefix, size_t fits, int max_width, int* width) {
+    // Widths only grow along the text, since no kerning undoes a whole
+    // advance, so the bytes that fit are the ones before the first too wide
+    size_t lo = 0;
+    size_t hi = fits;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (prefix[mid] <= max_width) lo = mid + 1;
+        else hi = mid;
+    }
+    if (width) *width = lo ? prefix[lo - 1] : 0;
+    return lo;
+}
+
+int glyph_atlas_draw(GlyphAtlas* atlas, const char* text, size_t len, int x, int y, SDL_Color color) {
+    if (!atlas || !text) return x;
+
+    // The whole run of glyphs goes out as one batch
+    static SpriteBatch batch;
+    sprite_batch_begin(&batch, atlas->renderer, atlas->texture, color);
+
+    unsigned char prev = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c < GLYPH_FIRST) continue;
+        if (prev) x += kerning(atlas, prev, c);
+
+        AtlasGlyph* glyph = load_glyph(atlas, c);
+        if (glyph->src.w > 0) {
+            SDL_Rect dst = { x, y, glyph->src.w, glyph->src.h };
+            sprite_batch_add(&batch, &glyph->src, &dst);
+        }
+        x += glyph->advance;
+        prev = c;
+    }
+    sprite_batch_end(&batch);
+    return x;
+}
+
+void glyph_atlas_shutdown(void) {
+    for (int i = 0; i < GLYPH_ATLAS_MAX_FONTS; i++) {
+        if (!atlases[i]) continue;
+        SDL_DestroyTexture(atlases[i]->texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+        free(atlases[i]);
+        atlases[i] = NULL;
+    }
+}
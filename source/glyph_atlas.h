@@ -0,0 +1,74 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <stddef.h>
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+/**
+ * Glyph atlas text renderer.
+ *
+ * Each font (an opened TTF_Font, so one face at one size) gets a single
+ * texture that its glyphs are rasterised into, white, the first time they
+ * are used. Text is then drawn as a single batch of tinted atlas sub-rects
+ * (see sprite_batch.h), and measured from cached advances and kerning, so drawing or
+ * re-colouring a label costs no TTF work. Like TTF_RenderText, text is
+ * treated as Latin-1.
+ */
+
+#define GLYPH_ATLAS_SIZE      1024
+#define GLYPH_ATLAS_MAX_FONTS 4
+
+typedef struct GlyphAtlas GlyphAtlas;
+
+/**
+ * Returns the atlas for font, creating it on first use.
+ *
+ * @return The atlas, or NULL if its texture could not be created
+ */
+GlyphAtlas* glyph_atlas_get(SDL_Renderer* renderer, TTF_Font* font);
+
+/**
+ * Returns the line height of the atlas font.
+ */
+int glyph_atlas_height(const GlyphAtlas* atlas);
+
+/**
+ * Returns the width in pixels of the first len bytes of text.
+ */
+int glyph_atlas_measure(GlyphAtlas* atlas, const char* text, size_t len);
+
+/**
+ * Returns how many of the first len bytes of text fit in max_width pixels.
+ * Measuring stops at the first glyph that does not fit, so the cost is the
+ * length that fits rather than the length of text.
+ *
+ * @param width  If not NULL, receives the width of the bytes that fit
+ * @param prefix If not NULL, receives the width of the first i + 1 bytes in
+ *               prefix[i] for every byte that fits, for glyph_atlas_refit()
+ */
+size_t glyph_atlas_fit(GlyphAtlas* atlas, const char* text, size_t len, int max_width, int* width,
+                       int* prefix);
+
+/**
+ * Returns how many of the fits bytes measured by glyph_atlas_fit() into
+ * prefix fit in a narrower max_width, by binary search over the widths
+ * rather than measuring the text again.
+ *
+ * @param width If not NULL, receives the width of the bytes that fit
+ */
+size_t glyph_atlas_refit(const int* prefix, size_t fits, int max_width, int* width);
+
+/**
+ * Draws the first len bytes of text with its top-left corner at x, y.
+ *
+ * @return The x position just past the last glyph drawn
+ */
+int glyph_atlas_draw(GlyphAtlas* atlas, const char* text, size_t len, int x, int y, SDL_Color color);
+
+/**
+ * Destroys every atlas. Must be called before the fonts are closed.
+ */
+void glyph_atlas_shutdown(void);
+
+#endif // GLYPH_ATLAS_H
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <string.h>
+#include "grid_view.h"
+#include "browser.h"
+#include "logging.h"
+#include "perf.h"
+
+// What the main thread has asked of a slot
+typedef struct {
+    uint32_t revision;      // Listing revision of the tile, 0 if empty
+    int index;
+    int requested;          // A load was started, or there is nothing to load
+} GridSlot;
+
+// What the render thread holds in a slot
+typedef struct {
+    uint32_t revision;
+    int index;
+    SDL_Texture* texture;
+    SDL_Rect size;
+} GridTexture;
+
+static int enabled = 0;
+static int top_row = 0;
+static int ahead = 1;           // Look-ahead row is below the screen (1) or above (-1)
+static GridSlot slots[GRID_SLOTS];
+
+// Read by loader threads
+static SDL_atomic_t wanted_revision;
+static SDL_atomic_t wanted_start;
+static SDL_atomic_t wanted_end;
+static SDL_atomic_t loads;
+
+// Render thread only
+static GridTexture textures[GRID_SLOTS];
+
+void grid_view_set_enabled(int on) {
+    enabled = on;
+}
+
+int grid_view_enabled(void) {
+    return enabled;
+}
+
+int grid_view_follow(int selected_index, int total) {
+    int row = selected_index / GRID_COLUMNS;
+    if (row < top_row) {
+        top_row = row;
+        ahead = -1;
+    } else if (row >= top_row + GRID_ROWS) {
+        top_row = row - GRID_ROWS + 1;
+        ahead = 1;
+    }
+
+    int last_top = (total + GRID_COLUMNS - 1) / GRID_COLUMNS - GRID_ROWS;
+    if (top_row > last_top) top_row = last_top;
+    if (top_row < 0) top_row = 0;
+    return top_row;
+}
+
+int grid_view_top_row(void) {
+    return top_row;
+}
+
+void grid_view_tiles(int total, int* start, int* end) {
+    // At the top there is nothing above to look ahead to
+    int above = ahead < 0 && top_row > 0;
+    *start = (top_row - above) * GRID_COLUMNS;
+    *end = (top_row + GRID_ROWS + !above) * GRID_COLUMNS;
+    if (*end > total) *end = total;
+    if (*start > *end) *start = *end;
+}
+
+// Starts a load for tile i if its slot has not had one yet
+// Returns 0 once no more loads may start
+static int request_tile(DirContent* content, const char* current_path, uint32_t revision, int i) {
+    GridSlot* slot = &slots[i % GRID_SLOTS];
+    if (slot->revision != revision || slot->index != i) {
+        slot->revision = revision;
+        slot->index = i;
+        slot->requested = 0;
+    }
+    if (slot->requested) return 1;
+    if (i < content->dir_count) {
+        slot->requested = 1;
+        return 1;
+    }
+    if (SDL_AtomicGet(&loads) >= GRID_MAX_LOADS) return 0;
+
+    // Marked requested even if no loader starts, so a failure isn't retried
+    // every frame
+    slot->requested = 1;
+    SDL_AtomicAdd(&loads, 1);
+    const char* name = dir_content_file_name(content, i - content->dir_count);
+    if (!load_grid_tile(current_path, name, revision, i)) SDL_AtomicAdd(&loads, -1);
+    return 1;
+}
+
+void grid_view_update(DirContent* content, const char* current_path, int selected_index) {
+    if (!content) return;
+
+    int total = content->dir_count + content->file_count;
+    uint32_t revision = dir_content_revision(content);
+    grid_view_follow(selected_index, total);
+
+    int start, end;
+    grid_view_tiles(total, &start, &end);
+    SDL_AtomicSet(&wanted_revision, (int)revision);
+    SDL_AtomicSet(&wanted_start, start);
+    SDL_AtomicSet(&wanted_end, end);
+
+    // Tiles on screen first, then the look-ahead row
+    int visible_start = top_row * GRID_COLUMNS;
+    int visible_end = visible_start + GRID_PAGE;
+    if (visible_end > end) visible_end = end;
+    for (int i = visible_start; i < visible_end; i++) {
+        if (!request_tile(content, current_path, revision, i)) return;
+    }
+    for (int i = start; i < end; i++) {
+        if (i >= visible_start && i < visible_end) continue;
+        if (!request_tile(content, current_path, revision, i)) return;
+    }
+}
+
+int grid_view_wanted(uint32_t revision, int index) {
+    return (uint32_t)SDL_AtomicGet(&wanted_revision) == revision &&
+           index >= SDL_AtomicGet(&wanted_start) && index < SDL_AtomicGet(&wanted_end);
+}
+
+void grid_view_load_done(void) {
+    SDL_AtomicAdd(&loads, -1);
+}
+
+int grid_view_accept(const GridTile* tile) {
+    if (!tile) return 0;
+    const GridSlot* slot = &slots[tile->index % GRID_SLOTS];
+    return tile->surface && slot->revision == tile->revision && slot->index == tile->index;
+}
+
+void grid_view_free_tile(GridTile* tile) {
+    if (!tile) return;
+    if (tile->surface) SDL_FreeSurface(tile->surface);
+    free(tile);
+}
+
+void grid_view_upload(SDL_Renderer* renderer, GridTile* tile) {
+    GridTexture* slot = &textures[tile->index % GRID_SLOTS];
+    if (slot->texture) {
+        SDL_DestroyTexture(slot->texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+    }
+    memset(slot, 0, sizeof(GridTexture));
+
+    slot->texture = SDL_CreateTextureFromSurface(renderer, tile->surface);
+    if (slot->texture) {
+        perf_count(PERF_TEXTURES_ALIVE, 1);
+        slot->revision = tile->revision;
+        slot->index = tile->index;
+        slot->size.w = tile->surface->w;
+        slot->size.h = tile->surface->h;
+    } else {
+        log_message(LOG_ERROR, "Couldn't create grid tile texture: %s", SDL_GetError());
+    }
+    grid_view_free_tile(tile);
+}
+
+SDL_Texture* grid_view_texture(uint32_t revision, int index, SDL_Rect* size) {
+    if (index < 0) return NULL;
+    GridTexture* slot = &textures[index % GRID_SLOTS];
+    if (!slot->texture || slot->revision != revision || slot->index != index) return NULL;
+    *size = slot->size;
+    return slot->texture;
+}
+
+SDL_Rect grid_view_tile_rect(int index, int first_row) {
+    SDL_Rect rect = {
+        GRID_LEFT + (index % GRID_COLUMNS) * GRID_PITCH_X,
+        GRID_TOP + (index / GRID_COLUMNS - first_row) * GRID_PITCH_Y,
+        GRID_TILE_W,
+        GRID_ART_H
+    };
+    return rect;
+}
+
+void grid_view_clear(void) {
+    for (int i = 0; i < GRID_SLOTS; i++) {
+        if (textures[i].texture) {
+            SDL_DestroyTexture(textures[i].texture);
+            perf_count(PERF_TEXTURES_ALIVE, -1);
+        }
+    }
+    memset(textures, 0, sizeof(textures));
+}
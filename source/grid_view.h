@@ -0,0 +1,133 @@
+#ifndef GRID_VIEW_H
+#define GRID_VIEW_H
+
+#include <stdint.h>
+#include <SDL.h>
+#include "config.h"
+#include "dir_content.h"
+
+/**
+ * Box art grid, an alternative to the text list when browsing files.
+ *
+ * Entries are laid out GRID_COLUMNS to a row as thumbnail tiles, keeping
+ * the listing's order and indices so the selection carries over between the
+ * grid and the list. Only the rows on screen plus one row of look-ahead in
+ * the direction the grid last scrolled have their box art loaded: tile i
+ * lives in slot i % GRID_SLOTS, loads are requested through the box art
+ * loader threads a few at a time, and art is shrunk to the tile size before
+ * it is handed to the render thread. Memory therefore depends on the grid
+ * size, not on the number of entries.
+ *
+ * Tiles are keyed by listing revision and index, like the list view's row
+ * slots, so a tile never shows art from a listing that has since changed.
+ */
+
+#define GRID_COLUMNS    5
+#define GRID_ROWS       2       // Rows on screen
+#define GRID_PAGE       (GRID_COLUMNS * GRID_ROWS)
+#define GRID_SLOTS      ((GRID_ROWS + 1) * GRID_COLUMNS)
+#define GRID_TILE_W     200     // Largest box art thumbnail
+#define GRID_ART_H      270
+#define GRID_PITCH_X    240     // Distance between tiles
+#define GRID_PITCH_Y    320
+#define GRID_LEFT       ((SCREEN_W - GRID_COLUMNS * GRID_PITCH_X + GRID_PITCH_X - GRID_TILE_W) / 2)
+#define GRID_TOP        30
+#define GRID_LABEL_GAP  8       // Between a tile's art and its label
+#define GRID_MAX_LOADS  4       // Box art loader threads running for the grid at once
+
+// SDL_USEREVENT code of a finished tile load; data1 is the GridTile, or NULL
+// if there was no art or the tile was no longer wanted
+#define GRID_EVENT_CODE 4
+
+// Box art shrunk to fit a tile, on its way from a loader thread to the
+// render thread
+typedef struct {
+    SDL_Surface* surface;
+    uint32_t revision;      // dir_content_revision() of the listing it was asked for
+    int index;              // Listing index of the tile
+} GridTile;
+
+/**
+ * Turns the grid on or off. It only shows while browsing files; favorites
+ * and history keep the list. Main thread only, like the rest of the grid's
+ * bookkeeping unless noted.
+ */
+void grid_view_set_enabled(int enabled);
+int grid_view_enabled(void);
+
+/**
+ * Scrolls the grid as little as possible to keep selected_index on screen.
+ *
+ * @return The listing row of tiles at the top of the screen
+ */
+int grid_view_follow(int selected_index, int total);
+
+/**
+ * Returns the row at the top of the screen as of the last grid_view_follow().
+ */
+int grid_view_top_row(void);
+
+/**
+ * Returns the tiles of a total-entry listing that should have box art
+ * resident: [*start, *end), the rows on screen and one row of look-ahead.
+ */
+void grid_view_tiles(int total, int* start, int* end);
+
+/**
+ * Follows the selection and asks the loader for box art of files that came
+ * into view, visible tiles first, keeping at most GRID_MAX_LOADS loads
+ * running. Directories have no art.
+ */
+void grid_view_update(DirContent* content, const char* current_path, int selected_index);
+
+/**
+ * Returns 1 if box art for tile index of the listing at revision is still
+ * wanted. Safe from any thread; loaders check it before decoding.
+ */
+int grid_view_wanted(uint32_t revision, int index);
+
+/**
+ * Called by a loader thread as it finishes a grid load, whatever the outcome,
+ * before it sends the GRID_EVENT_CODE event.
+ */
+void grid_view_load_done(void);
+
+/**
+ * Takes a tile delivered by a GRID_EVENT_CODE event.
+ *
+ * @return 1 if it should be posted to the render thread, 0 if it is stale
+ *         or NULL and should be freed with grid_view_free_tile()
+ */
+int grid_view_accept(const GridTile* tile);
+
+/**
+ * Frees a tile and its surface.
+ */
+void grid_view_free_tile(GridTile* tile);
+
+/**
+ * Uploads a tile as the texture for its slot, replacing whatever the slot
+ * held, and frees it. Render thread only.
+ */
+void grid_view_upload(SDL_Renderer* renderer, GridTile* tile);
+
+/**
+ * Returns the texture of tile index at revision, or NULL if it has not
+ * arrived. Render thread only.
+ *
+ * @param size Receives the texture's width and height
+ */
+SDL_Texture* grid_view_texture(uint32_t revision, int index, SDL_Rect* size);
+
+/**
+ * Returns the screen rect of the art area of tile index with top_row at the
+ * top of the screen.
+ */
+SDL_Rect grid_view_tile_rect(int index, int top_row);
+
+/**
+ * Destroys the tile textures. Render thread only, before the renderer goes.
+ */
+void grid_view_clear(void);
+
+#endif // GRID_VIEW_H
@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <string.h>
+#include "headless.h"
+#include "config.h"
+#include "frame.h"
+#include "input.h"
+#include "logging.h"
+
+// Longest a scripted step waits for its frame to be drawn
+#define HEADLESS_DRAW_WAIT_MS 1000
+
+static SDL_Surface* offscreen = NULL;
+
+void headless_parse_options(int argc, char** argv, HeadlessOptions* options) {
+    memset(options, 0, sizeof(HeadlessOptions));
+
+    const char* value = config_get("headless");
+    options->enabled = value && atoi(value) != 0;
+    value = config_get("headless_steps");
+    if (value) options->steps = atoi(value);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options->enabled = 1;
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            options->steps = atoi(argv[++i]);
+        }
+    }
+
+    if (options->steps < 0) options->steps = 0;
+    if (!options->enabled) options->steps = 0;
+}
+
+void headless_prepare(void) {
+    // Environment rather than hints so older SDL versions honour both
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    log_message(LOG_INFO, "Running headless on the dummy video driver");
+}
+
+SDL_Renderer* headless_create_renderer(void) {
+    offscreen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_W, SCREEN_H, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!offscreen) {
+        log_message(LOG_ERROR, "Offscreen surface creation failed: %s", SDL_GetError());
+        return NULL;
+    }
+
+    SDL_Renderer* software = SDL_CreateSoftwareRenderer(offscreen);
+    if (!software) {
+        log_message(LOG_ERROR, "Software renderer creation failed: %s", SDL_GetError());
+        SDL_FreeSurface(offscreen);
+        offscreen = NULL;
+    }
+    return software;
+}
+
+int headless_script_input(HeadlessOptions* options) {
+    if (options->steps == 0) return 0;
+
+    // The render thread drops frames it falls behind on, so each step waits
+    // for its frame to be drawn or the run would only time the main loop
+    if (!frame_wait_drawn(HEADLESS_DRAW_WAIT_MS)) {
+        log_message(LOG_ERROR, "Headless frame not drawn within %d ms", HEADLESS_DRAW_WAIT_MS);
+    }
+
+    SDL_Event event;
+    SDL_zero(event);
+    if (options->steps_done == 0) options->started = SDL_GetPerformanceCounter();
+
+    if (options->steps_done < options->steps) {
+        event.type = SDL_JOYBUTTONDOWN;
+        event.jbutton.button = DPAD_DOWN;
+        event.jbutton.state = SDL_PRESSED;
+        options->steps_done++;
+    } else {
+        double ms = (double)(SDL_GetPerformanceCounter() - options->started) * 1000.0 /
+                    (double)SDL_GetPerformanceFrequency();
+        log_message(LOG_INFO, "Headless run: %d steps in %.1f ms (%.3f ms per step)",
+                    options->steps, ms, ms / options->steps);
+        event.type = SDL_QUIT;
+        options->steps = 0;
+    }
+    return SDL_PushEvent(&event) == 1;
+}
+
+void headless_shutdown(void) {
+    if (offscreen) {
+        SDL_FreeSurface(offscreen);
+        offscreen = NULL;
+    }
+}
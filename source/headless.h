@@ -0,0 +1,55 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <SDL.h>
+
+/**
+ * Headless render backend for benchmarks and CI.
+ *
+ * With --headless on the command line (or "headless = 1" in the ini) SDL
+ * runs on its dummy video and audio drivers and everything is rendered by
+ * the software renderer into an offscreen surface, so the full browse and
+ * render path runs on a machine with no display or GPU. --steps N (or
+ * "headless_steps = N") scripts N presses of D-pad down, one per frame,
+ * then quits and logs how long they took, each step including the drawing
+ * of its frame on the render thread.
+ */
+
+typedef struct {
+    int enabled;
+    int steps;          // Scripted D-pad presses, 0 to wait for SDL_QUIT
+    int steps_done;
+    Uint64 started;     // Performance counter when the script started
+} HeadlessOptions;
+
+/**
+ * Reads the headless options from argv, falling back to the loaded config.
+ */
+void headless_parse_options(int argc, char** argv, HeadlessOptions* options);
+
+/**
+ * Selects SDL's dummy video and audio drivers. Must be called before SDL_Init.
+ */
+void headless_prepare(void);
+
+/**
+ * Creates a software renderer drawing into an offscreen SCREEN_W x SCREEN_H
+ * surface.
+ *
+ * @return The renderer, or NULL on failure
+ */
+SDL_Renderer* headless_create_renderer(void);
+
+/**
+ * Queues the next scripted input, or SDL_QUIT once the script is done.
+ *
+ * @return 1 if an event was queued, 0 if there is no script
+ */
+int headless_script_input(HeadlessOptions* options);
+
+/**
+ * Frees the offscreen surface. Call after destroying the renderer.
+ */
+void headless_shutdown(void);
+
+#endif // HEADLESS_H
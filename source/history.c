@@ -183,29 +183,20 @@ DirContent* list_history(void) {
     // Sort history entries
     sort_history();
 
-    // Allocate memory for file arrays
-    content->dirs = calloc(1, sizeof(char*));  // No directories in history view
-    content->files = calloc(MAX_HISTORY_ENTRIES, sizeof(char*));
-    content->dir_textures = calloc(1, sizeof(SDL_Texture*));
-    content->file_textures = calloc(MAX_HISTORY_ENTRIES, sizeof(SDL_Texture*));
-    content->dir_rects = calloc(1, sizeof(SDL_Rect));
-    content->file_rects = calloc(MAX_HISTORY_ENTRIES, sizeof(SDL_Rect));
-
-    if (!content->dirs || !content->files || !content->dir_textures ||
-        !content->file_textures || !content->dir_rects || !content->file_rects) {
+    // Allocate memory for file arrays (no directories in history view)
+    if (!dir_content_reserve(content, 0, MAX_HISTORY_ENTRIES)) {
         free_dir_content(content);
         return NULL;
     }
 
-    content->dir_count = 0;
-
     // If no history entries, show a message
     if (history_count == 0) {
-        content->files[0] = strdup("No history yet - play some games!");
-        content->file_count = 1;
-        // Initialize rect position for centering (will be adjusted in set_selection)
-        content->file_rects[0].x = 400; // Temporary value, will be centered
-        content->file_rects[0].y = 300; // Temporary value, will be centered
+        const char* message = "No history yet - play some games!";
+        if (!dir_content_add_file(content, message, strlen(message))) {
+            free_dir_content(content);
+            return NULL;
+        }
+        // draw_listing() centers the message on screen
         log_message(LOG_INFO, "No history entries found");
         return content;
     }
@@ -296,29 +287,19 @@ DirContent* list_history(void) {
 
             skip_name:
 
-            content->files[count] = strdup(display_name);
-
-            // Initialize rect position for rendering
-            if (content->files[count]) {
-                content->file_rects[count].x = 50;
-                content->file_rects[count].y = 50 + (count * 40);
+            if (dir_content_add_file(content, display_name, strlen(display_name))) {
                 count++;
                 log_message(LOG_DEBUG, "Added history entry %d: %s", count-1, display_name);
             }
         } else {
             // Fallback if we can't parse the filename
-            content->files[count] = strdup(path);
-            if (content->files[count]) {
-                // Initialize rect position
-                content->file_rects[count].x = 50;
-                content->file_rects[count].y = 50 + (count * 40);
+            if (dir_content_add_file(content, path, strlen(path))) {
                 count++;
                 log_message(LOG_DEBUG, "Added history entry %d (fallback): %s", count-1, path);
             }
         }
     }
 
-    content->file_count = count;
     log_message(LOG_INFO, "Listed %d history entries", count);
 
     return content;
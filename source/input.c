@@ -2,6 +2,7 @@
 #include "logging.h"
 #include "favorites.h"
 #include "config.h"
+#include "grid_view.h"
 
 // Global variables that are defined in main.c and accessed here
 int selected_index;
@@ -12,13 +13,9 @@ int menu_selection;
 DirContent* content;
 DirContent* favorites_content;
 DirContent* history_content;
-SDL_Renderer* renderer;
-TTF_Font* font;
 SDL_Joystick* joystick;
 AppMode current_app_mode;
 BrowserMode current_browser_mode;
-SDL_Texture* menu_textures[MENU_OPTIONS];
-SDL_Rect menu_rects[MENU_OPTIONS];
 const char* menu_options[] = {"Help", "History", "Scraper", "Quit"};
 
 // Helper function to get current content based on browser mode
@@ -33,8 +30,33 @@ DirContent* get_current_content(void) {
     return content;
 }
 
+// Whether the files browser is showing the box art grid
+int grid_browsing(void) {
+    return current_app_mode == APP_MODE_BROWSER && current_browser_mode == BROWSER_MODE_FILES &&
+           grid_view_enabled();
+}
+
+// Moves the grid selection by step tiles, stopping at either end of the
+// listing rather than wrapping
+void handle_grid_navigation(int step, const char* current_path) {
+    if (total_entries <= 0) return;
+
+    selected_index += step;
+    if (selected_index < 0) selected_index = 0;
+    if (selected_index > total_entries - 1) selected_index = total_entries - 1;
+
+    // The list page follows along for when the grid is turned off
+    current_page = selected_index / ENTRIES_PER_PAGE;
+    set_selection(content, selected_index, current_path);
+}
+
 // Helper function for up navigation
 void handle_up_navigation(const char* current_path) {
+    if (grid_browsing()) {
+        handle_grid_navigation(-GRID_COLUMNS, current_path);
+        return;
+    }
+
     if (selected_index > 0)
         selected_index--;
     else
@@ -42,7 +64,7 @@ void handle_up_navigation(const char* current_path) {
 
     current_page = selected_index / ENTRIES_PER_PAGE;
     DirContent* current_content = get_current_content();
-    set_selection(current_content, renderer, font, selected_index, current_page, current_path);
+    set_selection(current_content, selected_index, current_path);
 
     if (current_app_mode == APP_MODE_BROWSER &&
         current_browser_mode == BROWSER_MODE_FILES) {
@@ -53,6 +75,11 @@ void handle_up_navigation(const char* current_path) {
 
 // Helper function for down navigation
 void handle_down_navigation(const char* current_path) {
+    if (grid_browsing()) {
+        handle_grid_navigation(GRID_COLUMNS, current_path);
+        return;
+    }
+
     if (selected_index < total_entries - 1)
         selected_index++;
     else
@@ -60,7 +87,7 @@ void handle_down_navigation(const char* current_path) {
 
     current_page = selected_index / ENTRIES_PER_PAGE;
     DirContent* current_content = get_current_content();
-    set_selection(current_content, renderer, font, selected_index, current_page, current_path);
+    set_selection(current_content, selected_index, current_path);
 
     if (current_app_mode == APP_MODE_BROWSER &&
         current_browser_mode == BROWSER_MODE_FILES) {
@@ -71,6 +98,11 @@ void handle_down_navigation(const char* current_path) {
 
 // Helper function to handle navigation input
 void handle_navigation_input(int direction, const char* current_path) {
+    if (grid_browsing()) {
+        handle_grid_navigation(direction * GRID_COLUMNS, current_path);
+        return;
+    }
+
     if (current_app_mode == APP_MODE_BROWSER && current_browser_mode == BROWSER_MODE_FAVORITES && favorites_content) {
         // In favorites mode, skip group headers
         selected_index = find_next_rom(favorites_content, selected_index, direction);
@@ -93,7 +125,7 @@ void handle_navigation_input(int direction, const char* current_path) {
 
     current_page = selected_index / ENTRIES_PER_PAGE;
     DirContent* current_content = get_current_content();
-    set_selection(current_content, renderer, font, selected_index, current_page, current_path);
+    set_selection(current_content, selected_index, current_path);
 
     // Load box art for selected file when navigating
     if (current_app_mode == APP_MODE_BROWSER &&
@@ -104,6 +136,11 @@ void handle_navigation_input(int direction, const char* current_path) {
 
 // Helper function to handle page navigation (for shoulder buttons)
 void handle_page_navigation(int direction, const char* current_path) {
+    if (grid_browsing()) {
+        handle_grid_navigation(direction * GRID_PAGE, current_path);
+        return;
+    }
+
     if (direction < 0) {
         if (current_page > 0)
             current_page--;
@@ -118,23 +155,18 @@ void handle_page_navigation(int direction, const char* current_path) {
 
     selected_index = current_page * ENTRIES_PER_PAGE;
     DirContent* current_content = get_current_content();
-    set_selection(current_content, renderer, font, selected_index, current_page, current_path);
+    set_selection(current_content, selected_index, current_path);
 }
 
-// Helper function to update menu selection
-void update_menu_selection(int new_selection, const char* current_path) {
+// Helper function to update menu selection; the render thread draws the
+// menu from menu_options
+void update_menu_selection(int new_selection) {
     menu_selection = new_selection;
-
-    // Update menu textures
-    for (int i = 0; i < MENU_OPTIONS; i++) {
-        if (menu_textures[i]) SDL_DestroyTexture(menu_textures[i]);
-        SDL_Color color = (i == menu_selection) ? COLOR_TEXT_SELECTED : COLOR_TEXT;
-        menu_textures[i] = render_text(renderer, menu_options[i], font, color, &menu_rects[i], 0, current_path);
-    }
 }
 
 // Helper function to handle button repeat for navigation
-void handle_button_repeat(int button, int *held_state, int *initial_delay_state,
+// Returns 1 if the action was repeated
+int handle_button_repeat(int button, int *held_state, int *initial_delay_state,
                          Uint32 *repeat_time, Uint32 now, void (*action_fn)(const char*), const char* action_param) {
     if (SDL_JoystickGetButton(joystick, button)) {
         if (!(*held_state)) {
@@ -150,11 +182,21 @@ void handle_button_repeat(int button, int *held_state, int *initial_delay_state,
                 action_fn(action_param);
                 *initial_delay_state = 0;  // Switch to repeat phase
                 *repeat_time = now;
+                return 1;
             }
         }
     } else {
         *held_state = 0;
     }
+    return 0;
+}
+
+// Milliseconds until a held button repeats after delay, or UINT32_MAX if
+// it is not held
+Uint32 button_repeat_wait(int held_state, Uint32 delay, Uint32 repeat_time, Uint32 now) {
+    if (!held_state) return UINT32_MAX;
+    Uint32 elapsed = now - repeat_time;
+    return elapsed >= delay ? 0 : delay - elapsed;
 }
 
 // Function to update box art based on current selection
@@ -166,7 +208,7 @@ void update_box_art_for_selection(DirContent* dir_content, const char* current_p
         index < dir_content->dir_count + dir_content->file_count) {
         int file_index = index - dir_content->dir_count;
         if (file_index >= 0 && file_index < dir_content->file_count) {
-            const char* filename = dir_content->files[file_index];
+            const char* filename = dir_content_file_name(dir_content, file_index);
             log_message(LOG_DEBUG, "Loading box art for: %s", filename);
             load_box_art(dir_content, current_path, filename);
         }
@@ -16,6 +16,8 @@
 #define JOY_RIGHT 14
 #define JOY_LEFT_SHOULDER 6
 #define JOY_RIGHT_SHOULDER 7
+#define JOY_LEFT_STICK 4
+#define JOY_RIGHT_STICK 5
 #define DPAD_UP    13
 #define DPAD_DOWN  15
 
@@ -29,6 +31,8 @@
 // Timing constants for button repeat behavior
 #define INITIAL_DELAY_MS 300  // Initial delay before auto-repeat starts
 #define REPEAT_DELAY_MS 50    // Delay between repeats after initial delay
+#define PAGE_REPEAT_MS 50     // Delay between page turns while a shoulder button is held
+#define IDLE_WAIT_MS 100      // Longest the main loop sleeps waiting for input
 
 typedef enum {
     APP_MODE_BROWSER,
@@ -47,9 +51,12 @@ void handle_up_navigation(const char* current_path);
 void handle_down_navigation(const char* current_path);
 void handle_page_navigation(int direction, const char* current_path);
 void handle_navigation_input(int direction, const char* current_path);
-void update_menu_selection(int new_selection, const char* current_path);
-void handle_button_repeat(int button, int *held_state, int *initial_delay_state,
+void handle_grid_navigation(int step, const char* current_path);
+int grid_browsing(void);
+void update_menu_selection(int new_selection);
+int handle_button_repeat(int button, int *held_state, int *initial_delay_state,
                          Uint32 *repeat_time, Uint32 now, void (*action_fn)(const char*), const char* action_param);
+Uint32 button_repeat_wait(int held_state, Uint32 delay, Uint32 repeat_time, Uint32 now);
 DirContent* get_current_content(void);
 void update_box_art_for_selection(DirContent* content, const char* current_path, int selected_index);
 
@@ -62,13 +69,9 @@ extern int menu_selection;
 extern DirContent* content;
 extern DirContent* favorites_content;
 extern DirContent* history_content;
-extern SDL_Renderer* renderer;
-extern TTF_Font* font;
 extern SDL_Joystick* joystick;
 extern AppMode current_app_mode;
 extern BrowserMode current_browser_mode;
-extern SDL_Texture* menu_textures[];
-extern SDL_Rect menu_rects[];
 extern const char* menu_options[];
 
 #endif // INPUT_H
@@ -19,14 +19,15 @@ const char* get_file_extension(const char* filename) {
     return dot + 1;
 }
 
-int launch_retroarch(const char* rom_path) {
+int launch_retroarch(const char* rom_path, SystemType system) {
     log_message(LOG_INFO, "Launch request for ROM: %s", rom_path);
 
     // Add to history before launching
     add_history_entry(rom_path, time(NULL));
     save_history();
 
-    const EmulatorConfig* ec = derive_emulator_from_path(rom_path);
+    const EmulatorConfig* ec = system != SYSTEM_UNKNOWN ?
+        derive_emulator_for_system(system) : derive_emulator_from_path(rom_path);
     if(ec == NULL) {
         log_message(LOG_ERROR, "Could not derive emulator for path: %s", rom_path);
         return 0;
@@ -2,12 +2,14 @@
 #define LAUNCH_H
 
 #include "config.h"
+#include "emulator_selection.h"
 
 /**
- * Launch RetroArch with the given ROM path.
+ * Launch RetroArch with the given ROM path. system is the ROM's system if
+ * already known, or SYSTEM_UNKNOWN to derive it from the path.
  * Returns 1 on success, 0 on failure.
  */
-int launch_retroarch(const char* rom_path);
+int launch_retroarch(const char* rom_path, SystemType system);
 
 #define PPSSPP_PATH "sdmc:/switch/ppsspp/PPSSPP_GL.nro"
 
@@ -0,0 +1,538 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "library.h"
+#include "logging.h"
+#include "config.h"
+#include "collation.h"
+
+#ifdef ROMLAUNCHER_BUILD_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// The records are written and mapped as they are in memory, so they must
+// have no padding: every field is naturally aligned and each size is a
+// multiple of 8, keeping the int64_t mtime of every LibraryDir aligned
+_Static_assert(sizeof(LibraryHeader) == 24, "LibraryHeader must have no padding");
+_Static_assert(sizeof(LibraryDir) == 24, "LibraryDir must have no padding");
+_Static_assert(sizeof(LibraryEntry) == 8, "LibraryEntry must have no padding");
+
+// The currently opened index. On Linux the file is mapped read-only; libnx
+// has no mmap so on the Switch the file is read into a single heap buffer.
+static struct {
+    const unsigned char *base;
+    size_t size;
+    int mapped;
+    const LibraryHeader *header;
+    const LibraryDir *dirs;
+    const LibraryEntry *entries;
+    const char *strings;
+} library;
+
+// Growable buffers used while scanning
+typedef struct {
+    char *data;
+    uint32_t size;
+    uint32_t capacity;
+} StringTable;
+
+typedef struct {
+    LibraryDir *items;
+    uint32_t count;
+    uint32_t capacity;
+} DirList;
+
+typedef struct {
+    LibraryEntry *items;
+    uint32_t count;
+    uint32_t capacity;
+} EntryList;
+
+static int64_t strings_add(StringTable *table, const char *str, size_t len) {
+    if ((uint64_t)table->size + len + 1 > UINT32_MAX) return -1;
+    if (table->size + len + 1 > table->capacity) {
+        uint32_t capacity = table->capacity ? table->capacity : 4096;
+        while (table->size + len + 1 > capacity) capacity *= 2;
+        char *data = realloc(table->data, capacity);
+        if (!data) return -1;
+        table->data = data;
+        table->capacity = capacity;
+    }
+    uint32_t offset = table->size;
+    memcpy(table->data + offset, str, len);
+    table->data[offset + len] = '\0';
+    table->size += len + 1;
+    return offset;
+}
+
+static LibraryDir* dirs_push(DirList *list) {
+    if (list->count >= list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+        LibraryDir *items = realloc(list->items, capacity * sizeof(LibraryDir));
+        if (!items) return NULL;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    LibraryDir *dir = &list->items[list->count++];
+    memset(dir, 0, sizeof(LibraryDir));
+    return dir;
+}
+
+static LibraryEntry* entries_push(EntryList *list) {
+    if (list->count >= list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 1024;
+        LibraryEntry *items = realloc(list->items, capacity * sizeof(LibraryEntry));
+        if (!items) return NULL;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    return &list->items[list->count++];
+}
+
+static int library_load(const char *index_path);
+static const LibraryDir* library_find_dir(const char *path);
+
+// qsort has no context argument; only used from the single-threaded build
+static const char *sort_strings;
+
+static int compare_dirs(const void *a, const void *b) {
+    const LibraryDir *da = a;
+    const LibraryDir *db = b;
+    return strcmp(sort_strings + da->path_offset, sort_strings + db->path_offset);
+}
+
+// Sorts a run of entries into browsing order by their collation keys
+static int sort_entries(LibraryEntry *run, uint32_t count, const StringTable *strings) {
+    if (count < 2) return 1;
+
+    size_t names_size = 0;
+    for (uint32_t i = 0; i < count; i++) names_size += run[i].name_length;
+
+    CollationSet set;
+    LibraryEntry *sorted = malloc(count * sizeof(LibraryEntry));
+    if (!sorted || !collation_set_init(&set, count, names_size)) {
+        free(sorted);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        collation_set_add(&set, strings->data + run[i].name_offset, run[i].name_length, i);
+    }
+    collation_set_sort(&set);
+    for (uint32_t i = 0; i < count; i++) sorted[i] = run[set.items[i].index];
+    memcpy(run, sorted, count * sizeof(LibraryEntry));
+
+    collation_set_free(&set);
+    free(sorted);
+    return 1;
+}
+
+// Reads one directory, appending its subdirectories followed by its files
+// (each group sorted) to entries.
+static int read_directory(const char *path, LibraryDir *record, EntryList *entries,
+                          StringTable *strings) {
+    record->first_entry = entries->count;
+
+    DIR *dir = opendir(path);
+    if (!dir) {
+        log_message(LOG_INFO, "Library scan failed to open directory: %s", path);
+        return 1;
+    }
+
+    uint32_t first = entries->count;
+    uint32_t dir_count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        size_t len = strlen(entry->d_name);
+        int64_t offset = strings_add(strings, entry->d_name, len);
+        LibraryEntry *item = entries_push(entries);
+        if (offset < 0 || !item) {
+            closedir(dir);
+            return 0;
+        }
+
+        item->name_offset = (uint32_t)offset;
+        item->name_length = (uint16_t)len;
+        item->flags = entry->d_type == DT_DIR ? LIBRARY_ENTRY_DIR : 0;
+        if (item->flags & LIBRARY_ENTRY_DIR) dir_count++;
+    }
+    closedir(dir);
+
+    // Partition directories ahead of files, then sort each group
+    LibraryEntry *run = entries->items + first;
+    uint32_t count = entries->count - first;
+    uint32_t split = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (run[i].flags & LIBRARY_ENTRY_DIR) {
+            LibraryEntry tmp = run[split];
+            run[split++] = run[i];
+            run[i] = tmp;
+        }
+    }
+    if (!sort_entries(run, dir_count, strings) ||
+        !sort_entries(run + dir_count, count - dir_count, strings)) {
+        return 0;
+    }
+
+    record->dir_count = dir_count;
+    record->file_count = count - dir_count;
+    return 1;
+}
+
+// Copies an unchanged listing out of the currently opened index
+static int copy_listing(const LibrarySlice *slice, LibraryDir *record, EntryList *entries,
+                        StringTable *strings) {
+    record->first_entry = entries->count;
+    record->dir_count = slice->dir_count;
+    record->file_count = slice->file_count;
+
+    for (int i = 0; i < slice->dir_count + slice->file_count; i++) {
+        const LibraryEntry *old = &slice->entries[i];
+        int64_t offset = strings_add(strings, library_entry_name(slice, i), old->name_length);
+        LibraryEntry *item = entries_push(entries);
+        if (offset < 0 || !item) return 0;
+
+        item->name_offset = (uint32_t)offset;
+        item->name_length = old->name_length;
+        item->flags = old->flags;
+    }
+    return 1;
+}
+
+// Compares a freshly read listing against the one stored in the index
+static int same_listing(const LibrarySlice *slice, const LibraryDir *record,
+                        const EntryList *entries, const StringTable *strings) {
+    if ((uint32_t)slice->dir_count != record->dir_count ||
+        (uint32_t)slice->file_count != record->file_count) {
+        return 0;
+    }
+
+    const LibraryEntry *items = entries->items + record->first_entry;
+    int count = slice->dir_count + slice->file_count;
+    for (int i = 0; i < count; i++) {
+        if (items[i].flags != slice->entries[i].flags ||
+            items[i].name_length != slice->entries[i].name_length ||
+            memcmp(strings->data + items[i].name_offset, library_entry_name(slice, i),
+                   items[i].name_length) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Produces the listing for dirs[dir_index], either by reusing the opened
+// index when the directory's mtime is unchanged or by reading it from disk,
+// then queues its subdirectories in dirs.
+static int scan_directory(uint32_t dir_index, DirList *dirs, EntryList *entries,
+                          StringTable *strings, time_t scan_started,
+                          uint32_t *rescanned, uint32_t *changed) {
+    char path[MAX_PATH_LEN];
+    strncpy(path, strings->data + dirs->items[dir_index].path_offset, MAX_PATH_LEN - 1);
+    path[MAX_PATH_LEN - 1] = '\0';
+
+    LibraryDir *record = &dirs->items[dir_index];
+    struct stat st;
+    int64_t mtime = stat(path, &st) == 0 ? (int64_t)st.st_mtime : 0;
+
+    // A directory modified in the same second the scan started can change
+    // again without its mtime moving, so leave it unstamped to be reread.
+    record->mtime = mtime < (int64_t)scan_started ? mtime : 0;
+
+    LibrarySlice slice;
+    const LibraryDir *old = library_find_dir(path);
+    int indexed = old && library_lookup(path, &slice);
+    if (indexed && old->mtime != 0 && old->mtime == mtime) {
+        if (!copy_listing(&slice, record, entries, strings)) return 0;
+    } else {
+        log_message(LOG_DEBUG, "Library rereading directory: %s", path);
+        if (!read_directory(path, record, entries, strings)) return 0;
+        (*rescanned)++;
+        if (!indexed || old->mtime != record->mtime ||
+            !same_listing(&slice, record, entries, strings)) {
+            (*changed)++;
+        }
+    }
+
+    // Queue the subdirectories; record may move when dirs grows
+    uint32_t first = record->first_entry;
+    uint32_t dir_count = record->dir_count;
+    for (uint32_t i = 0; i < dir_count; i++) {
+        char child[MAX_PATH_LEN];
+        int written = snprintf(child, sizeof(child), "%s/%s", path,
+                               strings->data + entries->items[first + i].name_offset);
+        if (written < 0 || (size_t)written >= sizeof(child)) {
+            log_message(LOG_ERROR, "Library scan path too long, skipping: %s", child);
+            continue;
+        }
+        int64_t offset = strings_add(strings, child, written);
+        LibraryDir *queued = dirs_push(dirs);
+        if (offset < 0 || !queued) return 0;
+        queued->path_offset = (uint32_t)offset;
+    }
+
+    return 1;
+}
+
+static int library_write(const char *index_path, const DirList *dirs,
+                         const EntryList *entries, const StringTable *strings) {
+    LibraryHeader header = {
+        .magic = LIBRARY_INDEX_MAGIC,
+        .version = LIBRARY_INDEX_VERSION,
+        .dir_count = dirs->count,
+        .entry_count = entries->count,
+        .strings_size = strings->size,
+        .reserved = 0
+    };
+
+    char tmp_path[MAX_PATH_LEN];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", index_path);
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        log_message(LOG_ERROR, "Could not open library index for writing: %s", tmp_path);
+        return 0;
+    }
+
+    int written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+        fwrite(dirs->items, sizeof(LibraryDir), dirs->count, fp) == dirs->count &&
+        fwrite(entries->items, sizeof(LibraryEntry), entries->count, fp) == entries->count &&
+        fwrite(strings->data, 1, strings->size, fp) == strings->size;
+    if (fclose(fp) != 0) written = 0;
+
+    if (!written) {
+        log_message(LOG_ERROR, "Failed to write library index: %s", tmp_path);
+        remove(tmp_path);
+        return 0;
+    }
+
+    // The index may still be mapped; drop it before replacing the file
+    library_close();
+
+    // FAT on the Switch refuses to rename over an existing file
+    remove(index_path);
+    if (rename(tmp_path, index_path) != 0) {
+        log_message(LOG_ERROR, "Failed to move library index into place: %s", index_path);
+        remove(tmp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Walks rom_directory and writes a new index. Directories whose mtime still
+// matches the opened index are copied from it instead of being read again.
+static int library_scan(const char *rom_directory, const char *index_path) {
+    StringTable strings = {0};
+    DirList dirs = {0};
+    EntryList entries = {0};
+    uint32_t rescanned = 0;
+    uint32_t changed = 0;
+    time_t scan_started = time(NULL);
+    int ok = 0;
+
+    int64_t root_offset = strings_add(&strings, rom_directory, strlen(rom_directory));
+    LibraryDir *root = dirs_push(&dirs);
+    if (root_offset < 0 || !root) goto done;
+    root->path_offset = (uint32_t)root_offset;
+
+    // Breadth-first walk; dirs doubles as the work queue
+    for (uint32_t i = 0; i < dirs.count; i++) {
+        if (!scan_directory(i, &dirs, &entries, &strings, scan_started, &rescanned, &changed)) {
+            log_message(LOG_ERROR, "Out of memory while scanning library");
+            goto done;
+        }
+    }
+
+    // Nothing changed on disk: keep the index that is already open
+    if (library.header && changed == 0 && dirs.count == library.header->dir_count) {
+        log_message(LOG_INFO, "Library index is up to date (%u directories, %u reread)",
+                    dirs.count, rescanned);
+        ok = 1;
+        goto done;
+    }
+
+    sort_strings = strings.data;
+    qsort(dirs.items, dirs.count, sizeof(LibraryDir), compare_dirs);
+
+    if (!library_write(index_path, &dirs, &entries, &strings)) goto done;
+
+    log_message(LOG_INFO, "Library index written: %u directories (%u rescanned), %u entries",
+                dirs.count, rescanned, entries.count);
+    ok = 1;
+
+done:
+    free(strings.data);
+    free(dirs.items);
+    free(entries.items);
+    return ok;
+}
+
+int library_build(const char *rom_directory, const char *index_path) {
+    log_message(LOG_INFO, "Building library index for %s", rom_directory);
+    library_close();
+    return library_scan(rom_directory, index_path);
+}
+
+int library_refresh(const char *rom_directory, const char *index_path) {
+    if (!library.header) return library_open(rom_directory, index_path);
+
+    log_message(LOG_INFO, "Refreshing library index for %s", rom_directory);
+    if (!library_scan(rom_directory, index_path)) return 0;
+    return library.header || library_load(index_path);
+}
+
+// Checks every offset in the index once, so lookups can trust them
+static int library_valid(void) {
+    const LibraryHeader *header = library.header;
+    if (library.strings[header->strings_size - 1] != '\0') return 0;
+
+    for (uint32_t i = 0; i < header->dir_count; i++) {
+        const LibraryDir *dir = &library.dirs[i];
+        uint64_t end = (uint64_t)dir->first_entry + dir->dir_count + dir->file_count;
+        if (dir->path_offset >= header->strings_size || end > header->entry_count) return 0;
+    }
+    for (uint32_t i = 0; i < header->entry_count; i++) {
+        // The name and its NUL must both lie inside the string table
+        const LibraryEntry *entry = &library.entries[i];
+        if ((uint64_t)entry->name_offset + entry->name_length >= header->strings_size) return 0;
+    }
+    return 1;
+}
+
+static int library_load(const char *index_path) {
+#ifdef ROMLAUNCHER_BUILD_LINUX
+    int fd = open(index_path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LibraryHeader)) {
+        close(fd);
+        return 0;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    library.base = base;
+    library.size = st.st_size;
+    library.mapped = 1;
+#else
+    FILE *fp = fopen(index_path, "rb");
+    if (!fp) return 0;
+
+    struct stat st;
+    if (stat(index_path, &st) != 0 || (size_t)st.st_size < sizeof(LibraryHeader)) {
+        fclose(fp);
+        return 0;
+    }
+
+    unsigned char *base = malloc(st.st_size);
+    if (!base || fread(base, 1, st.st_size, fp) != (size_t)st.st_size) {
+        free(base);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+
+    library.base = base;
+    library.size = st.st_size;
+    library.mapped = 0;
+#endif
+
+    const LibraryHeader *header = (const LibraryHeader *)library.base;
+    uint64_t expected = sizeof(LibraryHeader) +
+        (uint64_t)header->dir_count * sizeof(LibraryDir) +
+        (uint64_t)header->entry_count * sizeof(LibraryEntry) +
+        header->strings_size;
+
+    if (header->magic != LIBRARY_INDEX_MAGIC || header->version != LIBRARY_INDEX_VERSION ||
+        expected != library.size || header->strings_size == 0) {
+        log_message(LOG_INFO, "Library index is stale or invalid (version %u)", header->version);
+        library_close();
+        return 0;
+    }
+
+    library.header = header;
+    library.dirs = (const LibraryDir *)(library.base + sizeof(LibraryHeader));
+    library.entries = (const LibraryEntry *)(library.dirs + header->dir_count);
+    library.strings = (const char *)(library.entries + header->entry_count);
+
+    if (!library_valid()) {
+        log_message(LOG_ERROR, "Library index is corrupt");
+        library_close();
+        return 0;
+    }
+
+    return 1;
+}
+
+int library_open(const char *rom_directory, const char *index_path) {
+    library_close();
+
+    if (library_load(index_path)) {
+        if (library_find_dir(rom_directory)) {
+            log_message(LOG_INFO, "Opened library index: %u directories, %u entries",
+                        library.header->dir_count, library.header->entry_count);
+            return library_refresh(rom_directory, index_path);
+        }
+        log_message(LOG_INFO, "Library index does not cover %s", rom_directory);
+        library_close();
+    }
+
+    if (!library_build(rom_directory, index_path) || !library_load(index_path)) {
+        log_message(LOG_ERROR, "Library index unavailable, falling back to directory scans");
+        return 0;
+    }
+    return 1;
+}
+
+static const LibraryDir* library_find_dir(const char *path) {
+    if (!library.header || !path) return NULL;
+
+    uint32_t lo = 0;
+    uint32_t hi = library.header->dir_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const LibraryDir *dir = &library.dirs[mid];
+        int cmp = strcmp(path, library.strings + dir->path_offset);
+        if (cmp == 0) return dir;
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+int library_lookup(const char *path, LibrarySlice *slice) {
+    // library_load() checked every offset, so this is just the search
+    const LibraryDir *dir = library_find_dir(path);
+    if (!dir) return 0;
+
+    slice->entries = library.entries + dir->first_entry;
+    slice->strings = library.strings;
+    slice->dir_count = dir->dir_count;
+    slice->file_count = dir->file_count;
+    return 1;
+}
+
+const char* library_entry_name(const LibrarySlice *slice, int i) {
+    return slice->strings + slice->entries[i].name_offset;
+}
+
+void library_close(void) {
+    if (library.base) {
+#ifdef ROMLAUNCHER_BUILD_LINUX
+        if (library.mapped) munmap((void *)library.base, library.size);
+#else
+        free((void *)library.base);
+#endif
+    }
+    memset(&library, 0, sizeof(library));
+}
@@ -0,0 +1,102 @@
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * Persistent ROM library index.
+ *
+ * The index is a single binary file in ROMLAUNCHER_DATA_DIRECTORY laid out as:
+ *
+ *   LibraryHeader
+ *   LibraryDir[dir_count]       sorted by absolute path for binary search
+ *   LibraryEntry[entry_count]   one contiguous run per directory, in collation order
+ *   char strings[strings_size]  NUL-terminated paths and names
+ *
+ * All records are fixed size with no padding, so the file can be mapped and
+ * used in place.
+ */
+
+#define LIBRARY_INDEX_FILE ROMLAUNCHER_DATA_DIRECTORY "/library.idx"
+
+#define LIBRARY_INDEX_MAGIC   0x58444C52  // "RLDX"
+#define LIBRARY_INDEX_VERSION 3
+
+#define LIBRARY_ENTRY_DIR 0x1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t dir_count;
+    uint32_t entry_count;
+    uint32_t strings_size;
+    uint32_t reserved;
+} LibraryHeader;
+
+typedef struct {
+    uint32_t path_offset;   // Absolute directory path in the string table
+    uint32_t first_entry;   // Index of the directory's first LibraryEntry
+    uint32_t dir_count;     // Subdirectories come first...
+    uint32_t file_count;    // ...followed by files, each group sorted
+    int64_t mtime;          // Directory mtime when listed, 0 to force a reread
+} LibraryDir;
+
+typedef struct {
+    uint32_t name_offset;   // Entry name in the string table
+    uint16_t name_length;
+    uint16_t flags;         // LIBRARY_ENTRY_* bits
+} LibraryEntry;
+
+/**
+ * A read-only view of one directory's entries inside the index. Valid until
+ * library_close() is called.
+ */
+typedef struct {
+    const LibraryEntry *entries;
+    const char *strings;
+    int dir_count;
+    int file_count;
+} LibrarySlice;
+
+/**
+ * Opens the library index at index_path and refreshes it, building it with a
+ * full scan of rom_directory if it is missing, unreadable or from a different
+ * version.
+ *
+ * @return 1 if an index is available, 0 otherwise
+ */
+int library_open(const char *rom_directory, const char *index_path);
+
+/**
+ * Brings the opened index up to date with rom_directory. Every indexed
+ * directory is stat'ed, but only those whose mtime changed since they were
+ * listed are read again; all other listings are carried over as-is and the
+ * file is only rewritten when something changed.
+ *
+ * @return 1 if an index is available, 0 otherwise
+ */
+int library_refresh(const char *rom_directory, const char *index_path);
+
+/**
+ * Looks up the listing for an absolute directory path.
+ *
+ * @return 1 and fills slice if the directory is indexed, 0 otherwise
+ */
+int library_lookup(const char *path, LibrarySlice *slice);
+
+/**
+ * Returns the NUL-terminated name of entry i of a slice.
+ */
+const char* library_entry_name(const LibrarySlice *slice, int i);
+
+/**
+ * Scans rom_directory recursively and writes a fresh index to index_path.
+ *
+ * @return 1 on success, 0 on failure
+ */
+int library_build(const char *rom_directory, const char *index_path);
+
+void library_close(void);
+
+#endif // LIBRARY_H
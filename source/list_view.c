@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <string.h>
+#include "list_view.h"
+#include "config.h"
+#include "logging.h"
+#include "perf.h"
+#include "sprite_batch.h"
+
+typedef struct {
+    uint32_t revision;      // Listing revision drawn into the slot, 0 if empty
+    int index;              // Row drawn into the slot
+} ListSlot;
+
+static ListSlot slots[LIST_VIEW_SLOTS];
+static SDL_Texture* slot_texture = NULL;
+static TTF_Font* slot_font = NULL;
+static int slot_height = 0;
+
+static float budget_ms = LIST_ROW_BUDGET_MS;
+static int pending = 0;
+
+static float scroll_y = 0;
+static int target_y = 0;
+static Uint32 last_tick = 0;
+
+void list_view_scroll_to(int first_row, int animate) {
+    int target = first_row * LIST_ROW_PITCH;
+    if (!animate) {
+        scroll_y = (float)target;
+        target_y = target;
+        return;
+    }
+    if (target == target_y) return;
+
+    if (!list_view_scrolling()) last_tick = SDL_GetTicks();
+    target_y = target;
+
+    // Long scrolls such as wrapping round only show the last page moving
+    if (scroll_y < target_y - LIST_VIEW_HEIGHT) scroll_y = (float)(target_y - LIST_VIEW_HEIGHT);
+    if (scroll_y > target_y + LIST_VIEW_HEIGHT) scroll_y = (float)(target_y + LIST_VIEW_HEIGHT);
+}
+
+int list_view_update(Uint32 now) {
+    if (!list_view_scrolling()) return 0;
+
+    float step = (float)(now - last_tick) / LIST_SCROLL_MS;
+    last_tick = now;
+    if (step > 1) step = 1;
+    scroll_y += (target_y - scroll_y) * step;
+    if (scroll_y > target_y - 1 && scroll_y < target_y + 1) scroll_y = (float)target_y;
+    return list_view_scrolling();
+}
+
+int list_view_scrolling(void) {
+    return scroll_y != (float)target_y;
+}
+
+void list_view_visible(int total, int* start, int* end) {
+    int top = (int)scroll_y;
+    if (top < 0) top = 0;
+    *start = top / LIST_ROW_PITCH;
+    *end = (top + LIST_VIEW_HEIGHT + LIST_ROW_PITCH - 1) / LIST_ROW_PITCH;
+    if (*end > total) *end = total;
+    if (*start > *end) *start = *end;
+}
+
+int list_view_row_y(int index) {
+    return LIST_VIEW_TOP + index * LIST_ROW_PITCH - (int)scroll_y;
+}
+
+SDL_Rect list_view_viewport(void) {
+    SDL_Rect viewport = { 0, LIST_VIEW_TOP, SCREEN_W, LIST_VIEW_HEIGHT };
+    return viewport;
+}
+
+// Creates the slot texture, or recreates it for a different font
+static int prepare_slots(SDL_Renderer* renderer, TTF_Font* font, int row_height) {
+    if (slot_texture && slot_font == font && slot_height == row_height) return 1;
+    if (!SDL_RenderTargetSupported(renderer)) return 0;
+
+    list_view_clear();
+    slot_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                     SCREEN_W, LIST_VIEW_SLOTS * row_height);
+    if (!slot_texture) {
+        log_message(LOG_ERROR, "Couldn't create row slot texture: %s", SDL_GetError());
+        return 0;
+    }
+    perf_count(PERF_TEXTURES_ALIVE, 1);
+    SDL_SetTextureBlendMode(slot_texture, SDL_BLENDMODE_BLEND);
+    slot_font = font;
+    slot_height = row_height;
+    return 1;
+}
+
+static int slot_ready(int index, uint32_t revision) {
+    const ListSlot* slot = &slots[index % LIST_VIEW_SLOTS];
+    return slot->revision == revision && slot->index == index;
+}
+
+// Fills the slots of rows that don't hold the row at revision yet, in the
+// order given, clearing them to transparent first. At least one row is
+// drawn; after that it stops once the performance counter passes deadline.
+// Returns the number of rows drawn
+static int fill_slots(SDL_Renderer* renderer, int row_height, uint32_t revision, const int* rows,
+                      int count, Uint64 deadline, ListViewDrawRow draw_row, void* data) {
+    SDL_Texture* previous = NULL;
+    int drawn = 0;
+    for (int n = 0; n < count; n++) {
+        int i = rows[n];
+        if (slot_ready(i, revision)) continue;
+        if (drawn && SDL_GetPerformanceCounter() >= deadline) break;
+
+        if (!drawn) {
+            previous = SDL_GetRenderTarget(renderer);
+            SDL_SetRenderTarget(renderer, slot_texture);
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        }
+        SDL_Rect strip = { 0, (i % LIST_VIEW_SLOTS) * row_height, SCREEN_W, row_height };
+        SDL_RenderFillRect(renderer, &strip);
+        draw_row(data, i, strip.y);
+        slots[i % LIST_VIEW_SLOTS].revision = revision;
+        slots[i % LIST_VIEW_SLOTS].index = i;
+        drawn++;
+    }
+    if (drawn) SDL_SetRenderTarget(renderer, previous);
+    return drawn;
+}
+
+int list_view_draw(SDL_Renderer* renderer, TTF_Font* font, int row_height, uint32_t revision,
+                   int total, int selected, int hidden, ListViewDrawRow draw_row, void* data) {
+    if (!prepare_slots(renderer, font, row_height)) return 0;
+
+    int start, end;
+    list_view_visible(total, &start, &end);
+    if (start == end) {
+        pending = 0;
+        return 1;
+    }
+
+    // Rows nearest the selection are drawn first: the selection, then the
+    // row below it, the row above, two below and so on
+    int center = selected < start ? start : (selected >= end ? end - 1 : selected);
+    int order[LIST_VIEW_ROWS + 1];
+    int count = 0;
+    for (int d = 0; count < end - start; d++) {
+        if (center + d < end) order[count++] = center + d;
+        if (d > 0 && center - d >= start) order[count++] = center - d;
+    }
+    Uint64 deadline = SDL_GetPerformanceCounter() +
+                      (Uint64)(budget_ms * SDL_GetPerformanceFrequency() / 1000);
+    fill_slots(renderer, row_height, revision, order, count, deadline, draw_row, data);
+
+    // The ready slots go to the screen as one batch; the rest get a
+    // placeholder until a later frame has time for them
+    static SpriteBatch batch;
+    SDL_Rect placeholders[LIST_VIEW_ROWS + 1];
+    SDL_Color white = { 255, 255, 255, 255 };
+    pending = 0;
+    sprite_batch_begin(&batch, renderer, slot_texture, white);
+    for (int i = start; i < end; i++) {
+        if (i == hidden) continue;
+        if (!slot_ready(i, revision)) {
+            SDL_Rect placeholder = { LIST_VIEW_LEFT, list_view_row_y(i) + row_height / 4,
+                                     LIST_PLACEHOLDER_W, row_height / 2 };
+            placeholders[pending++] = placeholder;
+            continue;
+        }
+        SDL_Rect src = { 0, (i % LIST_VIEW_SLOTS) * row_height, SCREEN_W, row_height };
+        SDL_Rect dst = { 0, list_view_row_y(i), SCREEN_W, row_height };
+        sprite_batch_add(&batch, &src, &dst);
+    }
+    sprite_batch_end(&batch);
+
+    if (pending) {
+        SDL_SetRenderDrawColor(renderer, COLOR_ROW_PLACEHOLDER.r, COLOR_ROW_PLACEHOLDER.g,
+                               COLOR_ROW_PLACEHOLDER.b, COLOR_ROW_PLACEHOLDER.a);
+        SDL_RenderFillRects(renderer, placeholders, pending);
+    }
+    return 1;
+}
+
+int list_view_pending(void) {
+    return pending;
+}
+
+void list_view_set_budget(float ms) {
+    budget_ms = ms < 0 ? 0 : ms;
+}
+
+int list_view_prerender(SDL_Renderer* renderer, TTF_Font* font, int row_height, uint32_t revision,
+                        int start, int end, ListViewDrawRow draw_row, void* data) {
+    if (!prepare_slots(renderer, font, row_height)) return 0;
+
+    // More rows than there are slots would overwrite each other
+    int rows[LIST_VIEW_SLOTS];
+    int count = 0;
+    for (int i = start; i < end && count < LIST_VIEW_SLOTS; i++) rows[count++] = i;
+    return fill_slots(renderer, row_height, revision, rows, count, 0, draw_row, data);
+}
+
+void list_view_clear(void) {
+    if (slot_texture) {
+        SDL_DestroyTexture(slot_texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+        slot_texture = NULL;
+    }
+    memset(slots, 0, sizeof(slots));
+    pending = 0;
+    slot_font = NULL;
+    slot_height = 0;
+}
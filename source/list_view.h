@@ -0,0 +1,123 @@
+#ifndef LIST_VIEW_H
+#define LIST_VIEW_H
+
+#include <stdint.h>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "browser.h"
+
+/**
+ * Virtualized, smoothly scrolling list of text rows.
+ *
+ * Rows are drawn once into a fixed ring of row slots: horizontal strips of
+ * a single render target texture, with row i always kept in slot
+ * i % LIST_VIEW_SLOTS. There are enough slots for the page on screen, even
+ * mid-scroll, and the pages either side of it, which are drawn ahead while
+ * the render thread is idle (see list_view_prerender()) so that turning a
+ * page only copies rows that are already built. A slot is redrawn only when
+ * a different row or a new revision of the listing lands in it, so texture
+ * memory depends on the screen height, not on the number of entries.
+ *
+ * Filling slots is spread across frames: each frame draws rows for at most
+ * its budget (but always at least one row), nearest the selection first,
+ * and shows a placeholder bar for any row still waiting, so a page turn on
+ * a slow renderer costs a few quick frames rather than one long one. The
+ * visible slots are copied to the screen in a single batched draw.
+ *
+ * The viewport scrolls in pixels, easing toward the row it was asked to
+ * show, so turning a page slides the list rather than jumping.
+ */
+
+#define LIST_VIEW_LEFT        50    // Screen x rows start at
+#define LIST_VIEW_TOP         50    // Screen y of the first visible row
+#define LIST_ROW_PITCH        40    // Distance between rows
+#define LIST_VIEW_ROWS        ENTRIES_PER_PAGE
+#define LIST_VIEW_HEIGHT      (LIST_VIEW_ROWS * LIST_ROW_PITCH)
+#define LIST_VIEW_SLOTS       (3 * LIST_VIEW_ROWS + 1)
+#define LIST_SCROLL_MS        80    // Time constant of the scroll easing
+#define LIST_ROW_BUDGET_MS    4.0f  // Default time a frame may spend drawing rows into slots
+#define LIST_PLACEHOLDER_W    300   // Width of the bar shown for a row not drawn yet
+
+/**
+ * Draws row index with its top at y into the current render target, at its
+ * usual screen x, in the normal text colour.
+ */
+typedef void (*ListViewDrawRow)(void* data, int index, int y);
+
+/**
+ * Scrolls so that first_row is at the top of the viewport, easing there if
+ * animate is set and jumping otherwise. Scrolls of more than a page only
+ * animate the last page.
+ */
+void list_view_scroll_to(int first_row, int animate);
+
+/**
+ * Advances the scroll animation to now.
+ *
+ * @return 1 if the list is still moving and needs another frame
+ */
+int list_view_update(Uint32 now);
+
+/**
+ * Returns 1 while the list is scrolling toward its target.
+ */
+int list_view_scrolling(void);
+
+/**
+ * Returns the rows of a total-row list the viewport shows: [*start, *end).
+ */
+void list_view_visible(int total, int* start, int* end);
+
+/**
+ * Returns the screen y of row index at the current scroll.
+ */
+int list_view_row_y(int index);
+
+/**
+ * Returns the screen area rows are drawn in, for clipping.
+ */
+SDL_Rect list_view_viewport(void);
+
+/**
+ * Draws the visible rows of a total-row list, filling slots that do not
+ * already hold their row at revision by calling draw_row, starting from row
+ * selected and working outward until the frame's budget is spent. Row
+ * hidden, if not -1, is left off the screen for the caller to draw itself.
+ *
+ * @return 1 if drawn, 0 if the slots are unavailable (no render targets),
+ *         in which case the caller draws the rows itself
+ */
+int list_view_draw(SDL_Renderer* renderer, TTF_Font* font, int row_height, uint32_t revision,
+                   int total, int selected, int hidden, ListViewDrawRow draw_row, void* data);
+
+/**
+ * Returns the number of visible rows the last list_view_draw() left as
+ * placeholders; another frame is needed to fill them.
+ */
+int list_view_pending(void);
+
+/**
+ * Sets the time each frame may spend drawing rows into slots. Set before
+ * the render thread starts; "row_budget_ms" in romlauncher.ini.
+ */
+void list_view_set_budget(float ms);
+
+/**
+ * Draws the first row of [start, end) whose slot does not hold it at
+ * revision yet, so the caller can stop between rows as soon as there is
+ * something more urgent to do. At most LIST_VIEW_SLOTS rows from start are
+ * considered.
+ *
+ * @return 1 if a row was drawn, 0 if they were all ready or there are no
+ *         slots (no render targets)
+ */
+int list_view_prerender(SDL_Renderer* renderer, TTF_Font* font, int row_height, uint32_t revision,
+                        int start, int end, ListViewDrawRow draw_row, void* data);
+
+/**
+ * Destroys the slot texture. Called when render targets are lost and before
+ * the renderer is destroyed.
+ */
+void list_view_clear(void);
+
+#endif // LIST_VIEW_H
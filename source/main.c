@@ -9,6 +9,17 @@
 #include "history.h"
 #include "launch.h"
 #include "input.h"
+#include "library.h"
+#include "scanner.h"
+#include "dir_cache.h"
+#include "prefetch.h"
+#include "frame.h"
+#include "render_thread.h"
+#include "headless.h"
+#include "perf.h"
+#include "perf_hud.h"
+#include "grid_view.h"
+#include "list_view.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
@@ -21,12 +32,42 @@
 static char current_path[MAX_PATH_LEN];
 
 typedef struct {
-    char message[256];
-    SDL_Texture* texture;
-    SDL_Rect rect;
+    char message[FRAME_MESSAGE_MAX];
     int active;
 } Notification;
 
+// Describes what should be on screen and hands it to the render thread
+static void publish_frame(const Notification* notification) {
+    Frame* frame = frame_begin();
+    switch (current_app_mode) {
+        case APP_MODE_MENU:
+            frame->view = FRAME_VIEW_MENU;
+            break;
+        case APP_MODE_SCRAPING:
+            frame->view = FRAME_VIEW_SCRAPING;
+            break;
+        default:
+            frame->view = grid_browsing() ? FRAME_VIEW_GRID : FRAME_VIEW_LISTING;
+            break;
+    }
+    frame->menu_selection = menu_selection;
+    if (notification->active) {
+        strcpy(frame->notification, notification->message);
+    } else {
+        frame->notification[0] = '\0';
+    }
+
+    DirContent* current_content = get_current_content();
+    frame->box_art = current_content ? current_content->box_art : 0;
+    int first_row = current_page * ENTRIES_PER_PAGE;
+    if (frame->view == FRAME_VIEW_GRID) {
+        frame->grid_top_row = grid_view_top_row();
+        first_row = frame->grid_top_row * GRID_COLUMNS;
+    }
+    snapshot_listing(current_content, selected_index, first_row, &frame->listing);
+    frame_publish();
+}
+
 
 #ifdef ROMLAUNCHER_BUILD_LINUX
 int appletMainLoop() {
@@ -34,7 +75,7 @@ int appletMainLoop() {
 }
 #endif
 
-int main(int argc __attribute__((unused)), char** argv __attribute__((unused))) {
+int main(int argc, char** argv) {
     char log_filename[256];
     snprintf(log_filename, sizeof(log_filename), "%s/romlauncher-%ld.log", ROMLAUNCHER_DATA_DIRECTORY, (long)time(NULL));
     log_init(log_filename);
@@ -55,13 +96,31 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
 
     // Load config, favorites, and history
     load_config();
+    const char* highlight = config_get("highlight");
+    if (highlight && strcmp(highlight, "text") == 0) {
+        set_highlight_mode(HIGHLIGHT_TEXT);
+    }
+    const char* perf_hud = config_get("perf_hud");
+    if (perf_hud && strcmp(perf_hud, "1") == 0) {
+        perf_hud_set_enabled(1);
+    }
+    const char* row_budget = config_get("row_budget_ms");
+    if (row_budget) {
+        list_view_set_budget((float)atof(row_budget));
+    }
+    const char* view = config_get("view");
+    if (view && strcmp(view, "grid") == 0) {
+        grid_view_set_enabled(1);
+    }
+    HeadlessOptions headless;
+    headless_parse_options(argc, argv, &headless);
     load_favorites();
     load_history();
     log_message(LOG_INFO, "Config, favorites, and history loaded");
 
 
     int exit_requested = 0;
-    int wait = 25;
+    int redraw = 1;
     current_app_mode = APP_MODE_BROWSER;
     current_browser_mode = BROWSER_MODE_FILES;
     favorites_content = NULL;
@@ -69,15 +128,11 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
     log_message(LOG_DEBUG, "Initialized favorites_content to NULL");
     char saved_path[MAX_PATH_LEN];
     menu_selection = 0;
-    for (int i = 0; i < MENU_OPTIONS; i++) {
-        menu_textures[i] = NULL;
-    }
-
-    // Scraping mode message
-    SDL_Texture* scraping_message = NULL;
-    SDL_Rect scraping_rect;
 
     Notification notification = {0};
+    SDL_Window* window = NULL;
+    TTF_Font* font = NULL;
+    TTF_Font* small_font = NULL;
 
     SDL_Event event;
 
@@ -88,6 +143,8 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
 
     srand(time(NULL));
 
+    if (headless.enabled) headless_prepare();
+
     // Initialize SDL subsystems with proper error handling
     if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
         log_message(LOG_ERROR, "SDL_Init failed: %s", SDL_GetError());
@@ -130,28 +187,20 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
     ttf_initialized = 1;
     log_message(LOG_DEBUG, "TTF_Init completed");
 
-    SDL_Window* window = SDL_CreateWindow(NULL,
-                                        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                        SCREEN_W, SCREEN_H, SDL_WINDOW_SHOWN);
-    if (!window) {
-        log_message(LOG_ERROR, "Window creation failed: %s", SDL_GetError());
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-    log_message(LOG_DEBUG, "SDL window created");
-
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
-    if (!renderer) {
-        log_message(LOG_ERROR, "Renderer creation failed: %s", SDL_GetError());
-        SDL_DestroyWindow(window);
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+    // Headless runs have no window at all and draw into an offscreen surface
+    if (!headless.enabled) {
+        window = SDL_CreateWindow(NULL,
+                                  SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                  SCREEN_W, SCREEN_H, SDL_WINDOW_SHOWN);
+        if (!window) {
+            log_message(LOG_ERROR, "Window creation failed: %s", SDL_GetError());
+            TTF_Quit();
+            IMG_Quit();
+            SDL_Quit();
+            return 1;
+        }
+        log_message(LOG_DEBUG, "SDL window created");
     }
-    log_message(LOG_DEBUG, "SDL renderer created");
 
     // Initialize joystick with better cross-platform support
     SDL_JoystickEventState(SDL_ENABLE);
@@ -195,10 +244,10 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
 #ifdef ROMLAUNCHER_BUILD_LINUX
     // load fonts from romfs
     font = TTF_OpenFont(ROMLAUNCHER_DATA_DIRECTORY "/data/Raleway-Regular.ttf", 32);
-    TTF_Font* small_font = TTF_OpenFont(ROMLAUNCHER_DATA_DIRECTORY "/data/Raleway-Regular.ttf", 16);
+    small_font = TTF_OpenFont(ROMLAUNCHER_DATA_DIRECTORY "/data/Raleway-Regular.ttf", 16);
 #else
     font = TTF_OpenFont("/data/Raleway-Regular.ttf", 32);
-    TTF_Font* small_font = TTF_OpenFont("/data/Raleway-Regular.ttf", 16);
+    small_font = TTF_OpenFont("/data/Raleway-Regular.ttf", 16);
 #endif
 
     if((!font) || (!small_font)) {
@@ -206,6 +255,21 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
         exit(1);
     }
 
+    // From here on the renderer, and every texture, belong to the render thread
+    if (!render_thread_start(window, font, small_font)) {
+        render_thread_stop();
+        if (window) SDL_DestroyWindow(window);
+        headless_shutdown();
+        TTF_CloseFont(font);
+        TTF_CloseFont(small_font);
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    library_open(ROM_DIRECTORY, LIBRARY_INDEX_FILE);
+
     log_message(LOG_INFO, "About to list files");
     strncpy(current_path, ROM_DIRECTORY, sizeof(current_path) - 1);
     content = list_files(current_path);
@@ -224,7 +288,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
         current_browser_mode = BROWSER_MODE_FILES;
         content->is_history_view = 0;
         log_message(LOG_DEBUG, "Calling set_selection");
-        set_selection(content, renderer, font, selected_index, current_page, current_path);
+        set_selection(content, selected_index, current_path);
         if (current_browser_mode != BROWSER_MODE_FILES) {
             current_browser_mode = BROWSER_MODE_FILES;
             log_message(LOG_DEBUG, "Reset browser mode to FILES");
@@ -233,25 +297,22 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
 
     log_message(LOG_DEBUG, "Starting main loop");
 
-    // Initialize status bar elements
-    SDL_Rect status_bar = {0, SCREEN_H - STATUS_BAR_HEIGHT, SCREEN_W, STATUS_BAR_HEIGHT};
-    SDL_Color status_color = COLOR_STATUS_TEXT;
-    SDL_Rect status_rect;
-    SDL_Texture* status_text = render_text(renderer,
-        "- MENU    + QUIT    X BROWSE/FAVES/HISTORY    Y TOGGLE FAVORITE",
-        small_font, status_color, &status_rect, 0, current_path);
-    if (status_text) {
-        status_rect.x = (SCREEN_W - status_rect.w) / 2;
-        status_rect.y = SCREEN_H - STATUS_BAR_HEIGHT + (STATUS_BAR_HEIGHT - status_rect.h) / 2;
-    }
-
     while (!exit_requested
         && appletMainLoop()
         ) {
+        perf_frame_begin();
         while (SDL_PollEvent(&event)) {
+            // Input and async results (scan batches, box art) all arrive as
+            // events, so any event may have changed what is on screen
+            redraw = 1;
+
             if (event.type == SDL_QUIT)
                 exit_requested = 1;
 
+            // Some renderers lose the contents of target textures
+            if (event.type == SDL_RENDER_TARGETS_RESET)
+                render_thread_targets_reset();
+
             // main event queue handler - handle multiple controller input types
             if (event.type == SDL_JOYBUTTONDOWN) {
                 log_message(LOG_DEBUG, "Button pressed: %d", event.jbutton.button);
@@ -262,6 +323,23 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                     continue;
                 }
 
+                if (event.jbutton.button == JOY_RIGHT_STICK) {
+                    perf_hud_set_enabled(!perf_hud_enabled());
+                }
+
+                if (event.jbutton.button == JOY_LEFT_STICK) {
+                    grid_view_set_enabled(!grid_view_enabled());
+                    // The list shows the selection's box art again
+                    if (!grid_view_enabled() && current_app_mode == APP_MODE_BROWSER &&
+                        current_browser_mode == BROWSER_MODE_FILES) {
+                        update_box_art_for_selection(content, current_path, selected_index);
+                    }
+                }
+
+                if ((event.jbutton.button == JOY_LEFT || event.jbutton.button == JOY_RIGHT) && grid_browsing()) {
+                    handle_grid_navigation(event.jbutton.button == JOY_LEFT ? -1 : 1, current_path);
+                }
+
                 if (event.jbutton.button == DPAD_UP || event.jbutton.button == DPAD_DOWN) {
                     int direction = (event.jbutton.button == DPAD_UP) ? -1 : 1;
                     handle_navigation_input(direction, current_path);
@@ -278,7 +356,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                     total_entries = content->dir_count + content->file_count;
                                     current_page = 0;
                                     total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
-                                    set_selection(content, renderer, font, selected_index, current_page, current_path);
+                                    set_selection(content, selected_index, current_path);
                                 } else {
                                     int file_index = selected_index - content->dir_count;
                                     if (file_index >= 0 && file_index < content->file_count) {
@@ -286,24 +364,19 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                         int written;
                                         #ifdef ROMLAUNCHER_BUILD_LINUX
                                         // On Linux, use the full path
-                                        written = snprintf(rom_path, sizeof(rom_path), "%s/%s", current_path, content->files[file_index]);
+                                        written = snprintf(rom_path, sizeof(rom_path), "%s/%s", current_path, dir_content_file_name(content, file_index));
                                         #else
                                         // On Switch, skip the "sdmc:" prefix
-                                        written = snprintf(rom_path, sizeof(rom_path), "%s/%s", current_path + 5, content->files[file_index]);
+                                        written = snprintf(rom_path, sizeof(rom_path), "%s/%s", current_path + 5, dir_content_file_name(content, file_index));
                                         #endif
                                         if (written < 0 || (size_t)written >= sizeof(rom_path)) {
                                             log_message(LOG_ERROR, "ROM path construction failed (truncation or error)");
                                             continue;
                                         }
-                                        if (launch_retroarch(rom_path)) {
+                                        if (launch_retroarch(rom_path, content->files.system[file_index])) {
                                             exit_requested = 1;
                                         } else {
-                                            if (notification.texture) {
-                                                SDL_DestroyTexture(notification.texture);
-                                            }
-                                            notification.texture = render_text(renderer, "Error launching emulator", font, COLOR_TEXT_ERROR, &notification.rect, 0, current_path);
-                                            notification.rect.x = (SCREEN_W - notification.rect.w) / 2;
-                                            notification.rect.y = SCREEN_H - notification.rect.h - 20;
+                                            snprintf(notification.message, sizeof(notification.message), "Error launching emulator");
                                             notification.active = 1;
                                         }
                                     }
@@ -312,7 +385,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                 log_message(LOG_DEBUG, "Favorites mode: selected_index=%d, file_count=%d",
                                             selected_index, favorites_content ? favorites_content->file_count : -1);
                                 if (selected_index >= 0 && favorites_content && selected_index < favorites_content->file_count) {
-                                    if (!is_group_header(favorites_content->files[selected_index])) {
+                                    if (!is_group_header(dir_content_file_name(favorites_content, selected_index))) {
                                         log_message(LOG_DEBUG, "Selected favorite is not a group header");
                                         FavoriteGroup* group = favorites_content->groups;
                                         int count = 0;
@@ -325,15 +398,10 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                                 }
                                                 if (entry && entry->path) {
                                                     log_message(LOG_INFO, "Attempting to launch favorite: %s", entry->path);
-                                                    if (launch_retroarch(entry->path)) {
+                                                    if (launch_retroarch(entry->path, favorites_content->files.system[selected_index])) {
                                                         exit_requested = 1;
                                                     } else {
-                                                        if (notification.texture) {
-                                                            SDL_DestroyTexture(notification.texture);
-                                                        }
-                                                        notification.texture = render_text(renderer, "Error launching emulator", font, COLOR_TEXT_ERROR, &notification.rect, 0, current_path);
-                                                        notification.rect.x = (SCREEN_W - notification.rect.w) / 2;
-                                                        notification.rect.y = SCREEN_H - notification.rect.h - 20;
+                                                        snprintf(notification.message, sizeof(notification.message), "Error launching emulator");
                                                         notification.active = 1;
                                                     }
                                                 } else {
@@ -353,15 +421,10 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                     const char* rom_path = get_history_rom_path(selected_index);
                                     if (rom_path) {
                                         log_message(LOG_INFO, "Attempting to launch history entry: %s", rom_path);
-                                        if (launch_retroarch(rom_path)) {
+                                        if (launch_retroarch(rom_path, SYSTEM_UNKNOWN)) {
                                             exit_requested = 1;
                                         } else {
-                                            if (notification.texture) {
-                                                SDL_DestroyTexture(notification.texture);
-                                            }
-                                            notification.texture = render_text(renderer, "Error launching emulator", font, COLOR_TEXT_ERROR, &notification.rect, 0, current_path);
-                                            notification.rect.x = (SCREEN_W - notification.rect.w) / 2;
-                                            notification.rect.y = SCREEN_H - notification.rect.h - 20;
+                                            snprintf(notification.message, sizeof(notification.message), "Error launching emulator");
                                             notification.active = 1;
                                         }
                                     } else {
@@ -401,7 +464,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                     current_page = selected_index / ENTRIES_PER_PAGE;
                                     total_entries = favorites_content->file_count;
                                     total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
-                                    set_selection(favorites_content, renderer, font, selected_index, current_page, current_path);
+                                    set_selection(favorites_content, selected_index, current_path);
                                 }
                                 break;
 
@@ -420,7 +483,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                     current_page = 0;
                                     total_entries = history_content->file_count;
                                     total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
-                                    set_selection(history_content, renderer, font, selected_index, current_page, current_path);
+                                    set_selection(history_content, selected_index, current_path);
                                 }
                                 break;
 
@@ -436,7 +499,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                 current_path[MAX_PATH_LEN-1] = '\0';
                                 selected_index = 0;
                                 current_page = 0;
-                                set_selection(content, renderer, font, selected_index, current_page, current_path);
+                                set_selection(content, selected_index, current_path);
                                 break;
                         }
                     }
@@ -456,10 +519,10 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                         if (favorites_content) {
                             total_entries = favorites_content->file_count;
                             total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
-                            set_selection(favorites_content, renderer, font, selected_index, current_page, current_path);
+                            set_selection(favorites_content, selected_index, current_path);
                         }
                     } else {
-                        set_selection(content, renderer, font, selected_index, current_page, current_path);
+                        set_selection(content, selected_index, current_path);
 
                         // Load box art for selected file
                         update_box_art_for_selection(content, current_path, selected_index);
@@ -471,10 +534,6 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                         case APP_MODE_SCRAPING:
                             current_app_mode = APP_MODE_BROWSER;
                             current_browser_mode = BROWSER_MODE_FILES;
-                            if (scraping_message) {
-                                SDL_DestroyTexture(scraping_message);
-                                scraping_message = NULL;
-                            }
                             break;
                         case APP_MODE_BROWSER:
                             if (current_browser_mode == BROWSER_MODE_FAVORITES) {
@@ -485,7 +544,7 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                 current_path[MAX_PATH_LEN-1] = '\0';
                                 selected_index = 0;
                                 current_page = 0;
-                                set_selection(content, renderer, font, selected_index, current_page, current_path);
+                                set_selection(content, selected_index, current_path);
                             } else if (current_browser_mode == BROWSER_MODE_HISTORY) {
                                 if (history_content) free_dir_content(history_content);
                                 history_content = NULL;
@@ -494,14 +553,14 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                 current_path[MAX_PATH_LEN-1] = '\0';
                                 selected_index = 0;
                                 current_page = 0;
-                                set_selection(content, renderer, font, selected_index, current_page, current_path);
+                                set_selection(content, selected_index, current_path);
                             } else {
                                 go_up_directory(content, current_path, ROM_DIRECTORY);
                                 selected_index = 0;
                                 total_entries = content->dir_count + content->file_count;
                                 current_page = 0;
                                 total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
-                                set_selection(content, renderer, font, selected_index, current_page, current_path);
+                                set_selection(content, selected_index, current_path);
                             }
                             break;
                         default:
@@ -520,36 +579,20 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                 if (event.jbutton.button == JOY_MINUS) {
                     if (current_app_mode != APP_MODE_MENU) {
                         current_app_mode = APP_MODE_MENU;
-                        menu_selection = 0;
-
-                        // Create menu textures
-                        update_menu_selection(0, current_path);
-
-                        // Position menu items
-                        for (int i = 0; i < MENU_OPTIONS; i++) {
-                            menu_rects[i].x = (SCREEN_W - menu_rects[i].w) / 2;
-                            menu_rects[i].y = SCREEN_H/3 + i * 60;
-                        }
+                        update_menu_selection(0);
                     } else {
                         current_app_mode = APP_MODE_BROWSER;
-                        // Cleanup menu textures
-                        for (int i = 0; i < MENU_OPTIONS; i++) {
-                            if (menu_textures[i]) {
-                                SDL_DestroyTexture(menu_textures[i]);
-                                menu_textures[i] = NULL;
-                            }
-                        }
                     }
                 }
 
                 if (current_app_mode == APP_MODE_MENU) {
                     if (event.jbutton.button == DPAD_UP) {
                         int new_selection = (menu_selection > 0) ? menu_selection - 1 : MENU_OPTIONS - 1;
-                        update_menu_selection(new_selection, current_path);
+                        update_menu_selection(new_selection);
                     }
                     else if (event.jbutton.button == DPAD_DOWN) {
                         int new_selection = (menu_selection < MENU_OPTIONS - 1) ? menu_selection + 1 : 0;
-                        update_menu_selection(new_selection, current_path);
+                        update_menu_selection(new_selection);
                     }
                     else if (event.jbutton.button == JOY_A) {
                         switch (menu_selection) {
@@ -567,15 +610,11 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                                     total_entries = history_content->file_count;
                                     total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
                                     log_message(LOG_INFO, "Switching to history mode with %d entries", total_entries);
-                                    set_selection(history_content, renderer, font, selected_index, current_page, current_path);
+                                    set_selection(history_content, selected_index, current_path);
                                 }
                                 break;
                             case MENU_SCRAPER:
                                 current_app_mode = APP_MODE_SCRAPING;
-                                if (scraping_message) SDL_DestroyTexture(scraping_message);
-                                scraping_message = render_text(renderer, "Press B to stop", font, COLOR_TEXT, &scraping_rect, 0, current_path);
-                                scraping_rect.x = (SCREEN_W - scraping_rect.w) / 2;
-                                scraping_rect.y = (SCREEN_H - scraping_rect.h) / 2;
                                 break;
                             case MENU_QUIT:
                                 exit_requested = 1;
@@ -628,6 +667,39 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                     }
                 }
             }
+            else if (event.type == SDL_USEREVENT && event.user.code == SCANNER_EVENT_CODE) {
+                ScanBatch *batch = event.user.data1;
+                if (scanner_accept(batch) && content) {
+                    int browsing = current_app_mode == APP_MODE_BROWSER &&
+                                   current_browser_mode == BROWSER_MODE_FILES;
+                    int cursor = browsing ? selected_index : 0;
+                    if (apply_scan_batch(content, batch, current_path, &cursor) && browsing) {
+                        selected_index = cursor;
+                        total_entries = content->dir_count + content->file_count;
+                        current_page = selected_index / ENTRIES_PER_PAGE;
+                        total_pages = (total_entries + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
+                        set_selection(content, selected_index, current_path);
+                    }
+                    if (batch->done) {
+                        log_message(LOG_INFO, "Scan complete: %d directories and %d files",
+                                    content->dir_count, content->file_count);
+                    }
+                }
+                scanner_free_batch(batch);
+            }
+            else if (event.type == SDL_USEREVENT && event.user.code == PREFETCH_EVENT_CODE) {
+                prefetch_accept(event.user.data1);
+            }
+            else if (event.type == SDL_USEREVENT && event.user.code == GRID_EVENT_CODE) {
+                // The render thread uploads it and frees it. Any finished
+                // load, with a tile or not, lets the grid start more below
+                GridTile *tile = event.user.data1;
+                if (grid_view_accept(tile)) {
+                    render_thread_post_tile(tile);
+                } else {
+                    grid_view_free_tile(tile);
+                }
+            }
 #if LOAD_ARTWORK
             else if (event.type == SDL_USEREVENT && event.user.code == 1) {
                 int loaded_request_id = (int)(intptr_t)event.user.data2;
@@ -635,17 +707,12 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                     SDL_Surface *surface = event.user.data1;
                     DirContent* current_content = get_current_content();
                     if (current_content) {
-                        if (current_content->box_art_texture) {
-                            SDL_DestroyTexture(current_content->box_art_texture);
-                        }
-                        current_content->box_art_texture = SDL_CreateTextureFromSurface(renderer, surface);
-                        float aspect = (float)surface->w / surface->h;
-                        current_content->box_art_rect.w = BOXART_MAX_WIDTH;
-                        current_content->box_art_rect.h = (int)(BOXART_MAX_WIDTH / aspect);
-                        current_content->box_art_rect.x = 1280 - current_content->box_art_rect.w - 20;
-                        current_content->box_art_rect.y = (720 - current_content->box_art_rect.h) / 2;
+                        // The render thread uploads it and frees the surface
+                        current_content->box_art = loaded_request_id;
+                        render_thread_post_box_art(surface, loaded_request_id);
+                    } else {
+                        SDL_FreeSurface(surface);
                     }
-                    SDL_FreeSurface(surface);
                 } else {
                     SDL_Surface *surface = event.user.data1;
                     SDL_FreeSurface(surface);
@@ -653,19 +720,21 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
             }
 #endif
         }
+        perf_mark(PERF_PHASE_INPUT);
 
+        prefetch_update();
 
         // Process button repeats
         {
             Uint32 now = SDL_GetTicks();
 
             // Up button repeat
-            handle_button_repeat(DPAD_UP, &dpadUpHeld, &dpadUpInitialDelay, &dpadUpRepeatTime, now,
-                                 handle_up_navigation, current_path);
+            redraw |= handle_button_repeat(DPAD_UP, &dpadUpHeld, &dpadUpInitialDelay, &dpadUpRepeatTime, now,
+                                           handle_up_navigation, current_path);
 
             // Down button repeat
-            handle_button_repeat(DPAD_DOWN, &dpadDownHeld, &dpadDownInitialDelay, &dpadDownRepeatTime, now,
-                                 handle_down_navigation, current_path);
+            redraw |= handle_button_repeat(DPAD_DOWN, &dpadDownHeld, &dpadDownInitialDelay, &dpadDownRepeatTime, now,
+                                           handle_down_navigation, current_path);
 
             // Only process joystick input if joystick is valid
             if (joystick) {
@@ -674,9 +743,10 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                     if (!leftShoulderHeld) {
                         leftShoulderHeld = 1;
                         leftShoulderRepeatTime = now;
-                    } else if (now - leftShoulderRepeatTime >= 50) {
+                    } else if (now - leftShoulderRepeatTime >= PAGE_REPEAT_MS) {
                         handle_page_navigation(-1, current_path);
                         leftShoulderRepeatTime = now;
+                        redraw = 1;
                     }
                 } else {
                     leftShoulderHeld = 0;
@@ -687,85 +757,45 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
                     if (!rightShoulderHeld) {
                         rightShoulderHeld = 1;
                         rightShoulderRepeatTime = now;
-                    } else if (now - rightShoulderRepeatTime >= 50) {
+                    } else if (now - rightShoulderRepeatTime >= PAGE_REPEAT_MS) {
                         handle_page_navigation(1, current_path);
                         rightShoulderRepeatTime = now;
+                        redraw = 1;
                     }
                 } else {
                     rightShoulderHeld = 0;
                 }
             }
-        }
-
-        SDL_SetRenderDrawColor(renderer,
-            COLOR_BACKGROUND.r,
-            COLOR_BACKGROUND.g,
-            COLOR_BACKGROUND.b,
-            COLOR_BACKGROUND.a);
-        SDL_RenderClear(renderer);
-
-        // Draw semi-transparent background if notification is active
-        if (notification.active) {
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            SDL_RenderFillRect(renderer, NULL);
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
-        }
-
-        // Render directory and file listings, menu, or scraping message
-        if (current_app_mode == APP_MODE_SCRAPING && scraping_message) {
-            SDL_RenderCopy(renderer, scraping_message, NULL, &scraping_rect);
-        } else if (current_app_mode == APP_MODE_MENU) {
-            // Render menu options
-            for (int i = 0; i < MENU_OPTIONS; i++) {
-                if (menu_textures[i]) {
-                    SDL_RenderCopy(renderer, menu_textures[i], NULL, &menu_rects[i]);
-                }
-            }
-        } else {
-            DirContent* current_content = get_current_content();
-            if (current_content) {
-                for (int i = 0; i < current_content->dir_count; i++) {
-                    if (current_content->dir_textures[i]) {
-                        SDL_RenderCopy(renderer, current_content->dir_textures[i], NULL, &current_content->dir_rects[i]);
-                    }
-                }
-                for (int i = 0; i < current_content->file_count; i++) {
-                    if (current_content->file_textures[i]) {
-                        SDL_RenderCopy(renderer, current_content->file_textures[i], NULL, &current_content->file_rects[i]);
-                    }
-                }
-            }
-        }
 
-        // Render box art if available
-        if (current_app_mode != APP_MODE_MENU && current_app_mode != APP_MODE_SCRAPING) {
-            DirContent* current_content = get_current_content();
-            if (current_content && current_content->box_art_texture) {
-                SDL_RenderCopy(renderer, current_content->box_art_texture, NULL, &current_content->box_art_rect);
+            // Nothing changed: sleep until an event arrives or the next
+            // button repeat or prefetch is due, rather than redrawing the
+            // same frame
+            if (!redraw) {
+                // A scripted headless run feeds its next step instead
+                if (headless_script_input(&headless)) continue;
+
+                Uint32 timeout = SDL_min(IDLE_WAIT_MS, prefetch_wait());
+                timeout = SDL_min(timeout, button_repeat_wait(dpadUpHeld,
+                    dpadUpInitialDelay ? INITIAL_DELAY_MS : REPEAT_DELAY_MS, dpadUpRepeatTime, now));
+                timeout = SDL_min(timeout, button_repeat_wait(dpadDownHeld,
+                    dpadDownInitialDelay ? INITIAL_DELAY_MS : REPEAT_DELAY_MS, dpadDownRepeatTime, now));
+                timeout = SDL_min(timeout, button_repeat_wait(leftShoulderHeld, PAGE_REPEAT_MS,
+                                                              leftShoulderRepeatTime, now));
+                timeout = SDL_min(timeout, button_repeat_wait(rightShoulderHeld, PAGE_REPEAT_MS,
+                                                              rightShoulderRepeatTime, now));
+                if (timeout > 0) SDL_WaitEventTimeout(NULL, (int)timeout);
+                continue;
             }
+            redraw = 0;
         }
-
-        // Render notification if active
-        if (notification.active && notification.texture) {
-            SDL_RenderCopy(renderer, notification.texture, NULL, &notification.rect);
-        }
-
-        // Render status bar
-        SDL_SetRenderDrawColor(renderer,
-            COLOR_STATUS_BAR.r,
-            COLOR_STATUS_BAR.g,
-            COLOR_STATUS_BAR.b,
-            COLOR_STATUS_BAR.a);
-        SDL_RenderFillRect(renderer, &status_bar);
-
-        // Render status text
-        if (status_text) {
-            SDL_RenderCopy(renderer, status_text, NULL, &status_rect);
-        }
-
-        SDL_RenderPresent(renderer);
-        SDL_Delay(wait);
+        // Box art for tiles that came into view, before the frame shows them
+        if (grid_browsing()) grid_view_update(content, current_path, selected_index);
+
+        // Drawing happens on the render thread, so the next poll never
+        // waits for this frame to be presented
+        publish_frame(&notification);
+        perf_mark(PERF_PHASE_LOGIC);
+        perf_frame_submit();
     }
 
     // Flush any remaining events before cleanup
@@ -796,29 +826,8 @@ int main(int argc __attribute__((unused)), char** argv __attribute__((unused)))
 cleanup:
     log_message(LOG_INFO, "Starting cleanup sequence");
 
-    // Clean up all textures
-    if (notification.texture) {
-        SDL_DestroyTexture(notification.texture);
-        notification.texture = NULL;
-    }
-
-    if (scraping_message) {
-        SDL_DestroyTexture(scraping_message);
-        scraping_message = NULL;
-    }
-
-    if (status_text) {
-        SDL_DestroyTexture(status_text);
-        status_text = NULL;
-    }
-
-    // Clean up menu textures
-    for (int i = 0; i < MENU_OPTIONS; i++) {
-        if (menu_textures[i]) {
-            SDL_DestroyTexture(menu_textures[i]);
-            menu_textures[i] = NULL;
-        }
-    }
+    // The render thread releases every texture and the renderer on its way out
+    render_thread_stop();
 
     // Close joystick if it was opened
     if (joystick) {
@@ -827,17 +836,12 @@ cleanup:
     }
 
     // Clean up SDL systems in reverse order of initialization
-    if (renderer) {
-        log_message(LOG_DEBUG, "Destroying renderer");
-        SDL_DestroyRenderer(renderer);
-        renderer = NULL;
-    }
-
     if (window) {
         log_message(LOG_DEBUG, "Destroying window");
         SDL_DestroyWindow(window);
         window = NULL;
     }
+    headless_shutdown();
 
     if (font) {
         TTF_CloseFont(font);
@@ -872,6 +876,11 @@ cleanup:
     }
 #endif
 
+    prefetch_shutdown();
+    scanner_shutdown();
+    dir_cache_clear();
+    library_close();
+
     // Free config, favorites, history, and hash tables
     free_config();
     free_favorites();
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <string.h>
+#include "navigation.h"
+#include "browser.h"
+#include "config.h"
+#include "dir_cache.h"
+#include "library.h"
+#include "logging.h"
+#include "prefetch.h"
+
+static int generation = 0;
+
+// Favorite markers are resolved once per listing rather than on every draw
+static void resolve_favorites(DirContent* content, const char* path, int first_file) {
+    for (int i = first_file; i < content->file_count; i++) {
+        char full_path[MAX_PATH_LEN * 2];
+        snprintf(full_path, sizeof(full_path), "%s/%s", path, dir_content_file_name(content, i));
+        if (is_favorite(full_path)) dir_content_set_favorite(content, i, 1);
+    }
+}
+
+DirContent* list_files(const char* path) {
+    log_message(LOG_INFO, "Starting to list files");
+    generation++;
+
+    DirContent* content = dir_content_create();
+    if (!content) return NULL;
+    if (!dir_content_refill(content, path)) {
+        free_dir_content(content);
+        return NULL;
+    }
+    dir_content_trim(content);
+
+    resolve_favorites(content, path, 0);
+
+    if (content->dir_count > 0) {
+        log_message(LOG_INFO, "Directories:");
+        for (int i = 0; i < content->dir_count; i++) {
+            log_message(LOG_DEBUG, "[DIR] %s", dir_content_dir_name(content, i));
+        }
+    }
+
+    if (content->file_count > 0) {
+        log_message(LOG_DEBUG, "Files:");
+        for (int i = 0; i < content->file_count; i++) {
+            log_message(LOG_DEBUG, "%s", dir_content_file_name(content, i));
+        }
+    }
+
+    return content;
+}
+
+// Lists path straight from the library index when it is known there.
+// Otherwise returns an empty listing and streams the entries in from a
+// background scan (see apply_scan_batch).
+static DirContent* open_listing(const char* path) {
+    LibrarySlice slice;
+    if (library_lookup(path, &slice)) {
+        scanner_cancel();
+        return list_files(path);
+    }
+
+    DirContent* content = dir_content_create();
+    if (!content) return NULL;
+
+    if (!scanner_start(path)) {
+        free_dir_content(content);
+        return list_files(path);
+    }
+    return content;
+}
+
+int apply_scan_batch(DirContent* content, const ScanBatch* batch, const char* current_path,
+                     int* selected_index) {
+    if (!content || !batch) return 0;
+    if (batch->done) content->mtime = batch->mtime;
+    if (batch->entries->dir_count + batch->entries->file_count == 0) return 0;
+
+    // Remember what is selected so the cursor stays on it through the re-sort.
+    // An untouched cursor stays at the top instead.
+    char selected_name[MAX_PATH_LEN] = "";
+    int selected_dir = *selected_index < content->dir_count;
+    if (*selected_index > 0 && *selected_index < content->dir_count + content->file_count) {
+        const char* name = selected_dir ?
+            dir_content_dir_name(content, *selected_index) :
+            dir_content_file_name(content, *selected_index - content->dir_count);
+        strncpy(selected_name, name, MAX_PATH_LEN - 1);
+        selected_name[MAX_PATH_LEN - 1] = '\0';
+    }
+
+    int first_file = content->file_count;
+    if (!dir_content_append(content, batch->entries)) {
+        log_message(LOG_ERROR, "Out of memory adding scanned entries");
+    }
+    resolve_favorites(content, current_path, first_file);
+    if (!dir_content_sort(content)) {
+        log_message(LOG_ERROR, "Out of memory sorting scanned entries");
+    }
+
+    if (selected_name[0]) {
+        int count = selected_dir ? content->dir_count : content->file_count;
+        for (int i = 0; i < count; i++) {
+            const char* name = selected_dir ?
+                dir_content_dir_name(content, i) : dir_content_file_name(content, i);
+            if (strcmp(name, selected_name) == 0) {
+                *selected_index = selected_dir ? i : content->dir_count + i;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+// Refills content with the listing for path in place, keeping its buffers.
+// Mirrors open_listing: the index is used when it knows path, otherwise the
+// listing is emptied and streamed in by the scanner.
+static int refill_listing(DirContent* content, const char* path) {
+    LibrarySlice slice;
+    if (library_lookup(path, &slice)) {
+        scanner_cancel();
+    } else if (scanner_start(path)) {
+        dir_content_clear(content);
+        return 1;
+    }
+
+    if (!dir_content_refill(content, path)) return 0;
+    resolve_favorites(content, path, 0);
+    return 1;
+}
+
+// Parks the listing for old_path in the cache and swaps in the one for
+// new_path, straight from the cache when it is still fresh. A listing the
+// cache would not keep is refilled in place instead, so its buffers are
+// reused rather than freed and allocated again.
+static int replace_listing(DirContent* content, const char* old_path, const char* new_path) {
+    prefetch_request(NULL);
+    generation++;
+    DirContent* new_content = dir_cache_take(new_path);
+    if (new_content) {
+        scanner_cancel();
+        // Prefetched listings arrive without favorites
+        resolve_favorites(new_content, new_path, 0);
+    } else if (!dir_cache_accepts(content)) {
+        return refill_listing(content, new_path);
+    } else {
+        new_content = open_listing(new_path);
+        if (!new_content) return 0;
+    }
+
+    // Box art stops showing when changing directories
+    content->box_art = 0;
+
+    DirContent old_content = *content;
+    *content = *new_content;
+    *new_content = old_content;
+    dir_cache_put(old_path, new_content);
+    return 1;
+}
+
+void go_up_directory(DirContent* content, char* current_path, const char* rom_directory) {
+    char *last_slash = strrchr(current_path, '/');
+    if (last_slash && strcmp(current_path, rom_directory) != 0) {
+        char old_path[MAX_PATH_LEN];
+        strncpy(old_path, current_path, MAX_PATH_LEN - 1);
+        old_path[MAX_PATH_LEN - 1] = '\0';
+
+        *last_slash = '\0';
+        if (!replace_listing(content, old_path, current_path)) {
+            *last_slash = '/';
+        }
+    }
+}
+
+void change_directory(DirContent* content, int selected_index, char* current_path) {
+    if (!content || selected_index >= content->dir_count) return;
+
+    char new_path[MAX_PATH_LEN];
+    snprintf(new_path, MAX_PATH_LEN, "%s/%s", current_path, dir_content_dir_name(content, selected_index));
+
+    if (replace_listing(content, current_path, new_path)) {
+        strncpy(current_path, new_path, MAX_PATH_LEN - 1);
+        current_path[MAX_PATH_LEN - 1] = '\0';
+    }
+}
+
+int listing_generation(void) {
+    return generation;
+}
@@ -0,0 +1,32 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "dir_content.h"
+#include "scanner.h"
+
+/**
+ * Moving between directories: listings come from the directory cache, the
+ * library index or a background scan, and the one being left is parked in
+ * the cache. Main thread only.
+ */
+
+DirContent* list_files(const char* path);
+
+/**
+ * Merges a batch from the background scanner into content, keeping it
+ * sorted and keeping selected_index on the entry it pointed at.
+ *
+ * @return 1 if entries were added
+ */
+int apply_scan_batch(DirContent* content, const ScanBatch* batch, const char* current_path,
+                     int* selected_index);
+void go_up_directory(DirContent* content, char* current_path, const char* rom_directory);
+void change_directory(DirContent* content, int selected_index, char* current_path);
+
+/**
+ * Returns a count bumped whenever a different directory is listed, so the
+ * list view jumps to it rather than scrolling.
+ */
+int listing_generation(void);
+
+#endif // NAVIGATION_H
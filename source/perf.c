@@ -0,0 +1,86 @@
+#include <string.h>
+#include "perf.h"
+
+static SDL_atomic_t counters[PERF_COUNTER_COUNT];
+
+// Last recorded time of each phase in microseconds, read from either thread
+static SDL_atomic_t last_phase_us[PERF_PHASE_COUNT];
+
+// Input and logic timing, main thread only
+static Uint64 last_mark = 0;
+static float phase_ms[PERF_PHASE_COUNT];
+
+// Render timing and frame history, render thread only
+static Uint64 render_started = 0;
+static float frame_ms[PERF_HISTORY];
+static int frame_next = 0;      // Slot the next frame is written to
+static int frames_recorded = 0;
+
+static Uint32 raster_window_started = 0;
+static int rasters_per_second = 0;
+
+void perf_count(PerfCounter counter, int delta) {
+    SDL_AtomicAdd(&counters[counter], delta);
+}
+
+int perf_counter(PerfCounter counter) {
+    return SDL_AtomicGet(&counters[counter]);
+}
+
+static float elapsed_ms(Uint64 from, Uint64 to) {
+    return (float)((double)(to - from) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+static void set_phase(PerfPhase phase, float ms) {
+    SDL_AtomicSet(&last_phase_us[phase], (int)(ms * 1000));
+}
+
+void perf_frame_begin(void) {
+    last_mark = SDL_GetPerformanceCounter();
+    memset(phase_ms, 0, sizeof(phase_ms));
+}
+
+void perf_mark(PerfPhase phase) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    phase_ms[phase] += elapsed_ms(last_mark, now);
+    last_mark = now;
+}
+
+void perf_frame_submit(void) {
+    set_phase(PERF_PHASE_INPUT, phase_ms[PERF_PHASE_INPUT]);
+    set_phase(PERF_PHASE_LOGIC, phase_ms[PERF_PHASE_LOGIC]);
+}
+
+void perf_render_begin(void) {
+    render_started = SDL_GetPerformanceCounter();
+}
+
+void perf_frame_end(void) {
+    float render_ms = elapsed_ms(render_started, SDL_GetPerformanceCounter());
+    set_phase(PERF_PHASE_RENDER, render_ms);
+
+    frame_ms[frame_next] = render_ms;
+    frame_next = (frame_next + 1) % PERF_HISTORY;
+    if (frames_recorded < PERF_HISTORY) frames_recorded++;
+
+    Uint32 ticks = SDL_GetTicks();
+    if (ticks - raster_window_started >= 1000) {
+        rasters_per_second = SDL_AtomicSet(&counters[PERF_TEXT_RASTERS], 0);
+        raster_window_started = ticks;
+    }
+}
+
+float perf_phase_ms(PerfPhase phase) {
+    return SDL_AtomicGet(&last_phase_us[phase]) / 1000.0f;
+}
+
+int perf_frame_times(float* out) {
+    for (int i = 0; i < frames_recorded; i++) {
+        out[i] = frame_ms[(frame_next - frames_recorded + i + PERF_HISTORY) % PERF_HISTORY];
+    }
+    return frames_recorded;
+}
+
+int perf_rasters_per_second(void) {
+    return rasters_per_second;
+}
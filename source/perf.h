@@ -0,0 +1,89 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <SDL.h>
+
+/**
+ * Performance counters and frame timing.
+ *
+ * Counters are SDL atomics, so any thread can bump them from a hot path
+ * without taking a lock. Frame timing is split between the two threads
+ * that make a frame. The main loop calls perf_frame_begin(), perf_mark()
+ * after input and after logic, and perf_frame_submit() once it has
+ * published a frame; iterations that publish nothing are not recorded.
+ * The render thread brackets each frame it draws with perf_render_begin()
+ * and perf_frame_end(), and only it reads the frame history.
+ */
+
+#define PERF_HISTORY 120    // Frames kept for the frame-time histogram
+
+typedef enum {
+    PERF_TEXTURES_ALIVE,    // Textures created and not yet destroyed
+    PERF_TEXT_RASTERS,      // TTF rasterisations since the last rollover
+    PERF_BOXART_JOBS,       // Box art loader threads still running
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+typedef enum {
+    PERF_PHASE_INPUT,
+    PERF_PHASE_LOGIC,
+    PERF_PHASE_RENDER,
+    PERF_PHASE_COUNT
+} PerfPhase;
+
+/**
+ * Adds delta to counter. Safe from any thread.
+ */
+void perf_count(PerfCounter counter, int delta);
+
+/**
+ * Returns the current value of counter.
+ */
+int perf_counter(PerfCounter counter);
+
+void perf_frame_begin(void);
+
+/**
+ * Charges the time since the previous mark (or perf_frame_begin()) to phase.
+ * Main thread only.
+ */
+void perf_mark(PerfPhase phase);
+
+/**
+ * Makes the input and logic time of the iteration just published readable
+ * through perf_phase_ms().
+ */
+void perf_frame_submit(void);
+
+/**
+ * Starts timing a frame on the render thread.
+ */
+void perf_render_begin(void);
+
+/**
+ * Charges the time since perf_render_begin() to rendering and records it as
+ * the frame time. Once a second also rolls PERF_TEXT_RASTERS over into
+ * perf_rasters_per_second(). Render thread only.
+ */
+void perf_frame_end(void);
+
+/**
+ * Returns the time the last recorded frame spent in phase, in ms. Safe from
+ * any thread.
+ */
+float perf_phase_ms(PerfPhase phase);
+
+/**
+ * Copies the recorded frame times in ms, oldest first, into out, which
+ * must hold PERF_HISTORY values.
+ *
+ * @return The number of frames copied
+ */
+int perf_frame_times(float* out);
+
+/**
+ * Returns the text rasterisations counted over the last full second.
+ */
+int perf_rasters_per_second(void);
+
+#endif // PERF_H
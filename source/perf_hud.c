@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include "perf_hud.h"
+#include "perf.h"
+#include "config.h"
+#include "glyph_atlas.h"
+
+static SDL_atomic_t hud_enabled;
+
+void perf_hud_set_enabled(int enabled) {
+    SDL_AtomicSet(&hud_enabled, enabled);
+}
+
+int perf_hud_enabled(void) {
+    return SDL_AtomicGet(&hud_enabled);
+}
+
+static void set_draw_color(SDL_Renderer* renderer, SDL_Color color) {
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+}
+
+static void draw_histogram(SDL_Renderer* renderer, const SDL_Rect* area,
+                           const float* times, int count) {
+    // The full height is twice the frame budget, oldest frame on the left
+    float px_per_ms = area->h / (PERF_FRAME_BUDGET_MS * 2);
+    int bar_w = area->w / PERF_HISTORY;
+    int bottom = area->y + area->h;
+    SDL_Rect ok_bars[PERF_HISTORY];
+    SDL_Rect slow_bars[PERF_HISTORY];
+    int ok_count = 0, slow_count = 0;
+
+    for (int i = 0; i < count; i++) {
+        int h = (int)(times[i] * px_per_ms) + 1;
+        if (h > area->h) h = area->h;
+        SDL_Rect bar = {area->x + i * bar_w, bottom - h, bar_w, h};
+        if (times[i] > PERF_FRAME_BUDGET_MS) {
+            slow_bars[slow_count++] = bar;
+        } else {
+            ok_bars[ok_count++] = bar;
+        }
+    }
+
+    set_draw_color(renderer, COLOR_PERF_BAR);
+    SDL_RenderFillRects(renderer, ok_bars, ok_count);
+    set_draw_color(renderer, COLOR_PERF_SLOW_BAR);
+    SDL_RenderFillRects(renderer, slow_bars, slow_count);
+
+    int budget_y = bottom - (int)(PERF_FRAME_BUDGET_MS * px_per_ms);
+    set_draw_color(renderer, COLOR_PERF_TEXT);
+    SDL_RenderDrawLine(renderer, area->x, budget_y, area->x + area->w, budget_y);
+}
+
+void perf_hud_draw(SDL_Renderer* renderer, TTF_Font* font, const ListingSnapshot* listing) {
+    if (!perf_hud_enabled()) return;
+
+    GlyphAtlas* atlas = glyph_atlas_get(renderer, font);
+    if (!atlas) return;
+
+    SDL_Rect panel = {10, SCREEN_H - STATUS_BAR_HEIGHT - PERF_HUD_HEIGHT - 10, 800, PERF_HUD_HEIGHT};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    set_draw_color(renderer, COLOR_PERF_BACKGROUND);
+    SDL_RenderFillRect(renderer, &panel);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    float times[PERF_HISTORY];
+    int count = perf_frame_times(times);
+    SDL_Rect graph = {panel.x + 5, panel.y + 5, PERF_HISTORY * 2, panel.h - 10};
+    draw_histogram(renderer, &graph, times, count);
+
+    float total_ms = 0, worst_ms = 0;
+    for (int i = 0; i < count; i++) {
+        total_ms += times[i];
+        if (times[i] > worst_ms) worst_ms = times[i];
+    }
+
+    // Counters to the right of the graph
+    char line[160];
+    int x = graph.x + graph.w + 10;
+    int y = panel.y + 3;
+    int line_h = glyph_atlas_height(atlas);
+
+    snprintf(line, sizeof(line), "frame %.1f ms avg, %.1f max   input %.2f  logic %.2f  render %.2f",
+             count ? total_ms / count : 0.0f, worst_ms, perf_phase_ms(PERF_PHASE_INPUT),
+             perf_phase_ms(PERF_PHASE_LOGIC), perf_phase_ms(PERF_PHASE_RENDER));
+    glyph_atlas_draw(atlas, line, strlen(line), x, y, COLOR_PERF_TEXT);
+    y += line_h;
+
+    snprintf(line, sizeof(line), "textures %d   text rasters/s %d   box art jobs %d",
+             perf_counter(PERF_TEXTURES_ALIVE), perf_rasters_per_second(),
+             perf_counter(PERF_BOXART_JOBS));
+    glyph_atlas_draw(atlas, line, strlen(line), x, y, COLOR_PERF_TEXT);
+    y += line_h;
+
+    if (listing->present) {
+        snprintf(line, sizeof(line), "listing %d dirs, %d files, %zu KiB",
+                 listing->dir_count, listing->file_count, listing->bytes / 1024);
+    } else {
+        snprintf(line, sizeof(line), "no listing");
+    }
+    glyph_atlas_draw(atlas, line, strlen(line), x, y, COLOR_PERF_TEXT);
+}
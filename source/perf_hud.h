@@ -0,0 +1,33 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "browser.h"
+
+/**
+ * On-screen performance overlay.
+ *
+ * Drawn above the status bar with the glyph atlas, so showing it costs no
+ * text rasterisation of its own: a histogram of recent frame times against
+ * the frame budget, the last frame's input, logic and render time, the
+ * perf counters and the size of the current listing. Toggled with the right
+ * stick button, or turned on at start with "perf_hud = 1" in the ini.
+ */
+
+#define PERF_HUD_HEIGHT       70
+#define PERF_FRAME_BUDGET_MS  16.7f  // Slower frames get a red bar
+
+/**
+ * Turns the overlay on or off. Safe from any thread.
+ */
+void perf_hud_set_enabled(int enabled);
+int perf_hud_enabled(void);
+
+/**
+ * Draws the overlay if it is enabled, reporting listing as the current
+ * listing. Render thread only.
+ */
+void perf_hud_draw(SDL_Renderer* renderer, TTF_Font* font, const ListingSnapshot* listing);
+
+#endif // PERF_HUD_H
@@ -0,0 +1,165 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL.h>
+#include <SDL_thread.h>
+#include "prefetch.h"
+#include "dir_cache.h"
+#include "library.h"
+#include "logging.h"
+
+typedef struct {
+    char path[MAX_PATH_LEN];
+    int generation;
+} PrefetchRequest;
+
+// Bumped by the main thread whenever the target changes; workers poll it
+static SDL_atomic_t prefetch_generation;
+static SDL_Thread* prefetch_thread = NULL;
+
+// Main thread only: the target waiting out its dwell time, and the one
+// being read
+static char pending_path[MAX_PATH_LEN];
+static int pending = 0;
+static Uint32 pending_since = 0;
+static char active_path[MAX_PATH_LEN];
+
+static int prefetch_cancelled(const PrefetchRequest* req) {
+    return SDL_AtomicGet(&prefetch_generation) != req->generation;
+}
+
+static DirContent* read_directory(const PrefetchRequest* req) {
+    DirContent* content = dir_content_create();
+    if (!content) return NULL;
+    content->mtime = dir_cache_stamp(req->path);
+
+    DIR* dir = opendir(req->path);
+    if (!dir) {
+        free_dir_content(content);
+        return NULL;
+    }
+
+    int ok = 1;
+    struct dirent* entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        if (prefetch_cancelled(req) ||
+            content->dir_count + content->file_count >= PREFETCH_MAX_ENTRIES) {
+            ok = 0;
+            break;
+        }
+
+        size_t len = strlen(entry->d_name);
+        ok = entry->d_type == DT_DIR ?
+            dir_content_add_dir(content, entry->d_name, len) :
+            dir_content_add_file(content, entry->d_name, len);
+    }
+    closedir(dir);
+
+    if (!ok || !dir_content_sort(content)) {
+        free_dir_content(content);
+        return NULL;
+    }
+    dir_content_trim(content);
+    return content;
+}
+
+static int prefetch_thread_fn(void* data) {
+    PrefetchRequest* req = (PrefetchRequest*)data;
+
+    DirContent* content = read_directory(req);
+    PrefetchResult* result = content ? malloc(sizeof(PrefetchResult)) : NULL;
+    if (result && !prefetch_cancelled(req)) {
+        strcpy(result->path, req->path);
+        result->content = content;
+
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = SDL_USEREVENT;
+        event.user.code = PREFETCH_EVENT_CODE;
+        event.user.data1 = result;
+        if (SDL_PushEvent(&event) == 1) {
+            free(req);
+            return 0;
+        }
+    }
+
+    free(result);
+    free_dir_content(content);
+    free(req);
+    return 0;
+}
+
+static void cancel_active(void) {
+    SDL_AtomicAdd(&prefetch_generation, 1);
+    active_path[0] = '\0';
+}
+
+void prefetch_request(const char* path) {
+    if (!path) {
+        pending = 0;
+        if (active_path[0]) cancel_active();
+        return;
+    }
+
+    if (strlen(path) >= MAX_PATH_LEN) return;
+    if (pending && strcmp(pending_path, path) == 0) return;
+    if (!pending && strcmp(active_path, path) == 0) return;
+
+    if (active_path[0]) cancel_active();
+    strcpy(pending_path, path);
+    pending = 1;
+    pending_since = SDL_GetTicks();
+}
+
+void prefetch_update(void) {
+    if (!pending || SDL_GetTicks() - pending_since < PREFETCH_DWELL_MS) return;
+    pending = 0;
+
+    LibrarySlice slice;
+    if (library_lookup(pending_path, &slice) || dir_cache_contains(pending_path)) return;
+
+    // At most one worker: the previous one was cancelled and exits promptly
+    if (prefetch_thread) {
+        SDL_WaitThread(prefetch_thread, NULL);
+        prefetch_thread = NULL;
+    }
+
+    PrefetchRequest* req = malloc(sizeof(PrefetchRequest));
+    if (!req) return;
+    strcpy(req->path, pending_path);
+    req->generation = SDL_AtomicGet(&prefetch_generation);
+
+    prefetch_thread = SDL_CreateThread(prefetch_thread_fn, "Prefetch", req);
+    if (!prefetch_thread) {
+        free(req);
+        return;
+    }
+    strcpy(active_path, pending_path);
+    log_message(LOG_DEBUG, "Prefetching %s", pending_path);
+}
+
+Uint32 prefetch_wait(void) {
+    if (!pending) return UINT32_MAX;
+    Uint32 elapsed = SDL_GetTicks() - pending_since;
+    return elapsed >= PREFETCH_DWELL_MS ? 0 : PREFETCH_DWELL_MS - elapsed;
+}
+
+void prefetch_accept(PrefetchResult* result) {
+    if (!result) return;
+    if (strcmp(result->path, active_path) == 0) active_path[0] = '\0';
+
+    dir_cache_put(result->path, result->content);
+    free(result);
+}
+
+void prefetch_shutdown(void) {
+    pending = 0;
+    cancel_active();
+    if (prefetch_thread) {
+        SDL_WaitThread(prefetch_thread, NULL);
+        prefetch_thread = NULL;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include "dir_content.h"
+#include "config.h"
+
+/**
+ * Speculative prefetch of the highlighted subdirectory.
+ *
+ * When a directory row stays highlighted for PREFETCH_DWELL_MS, its listing
+ * is read and sorted on a worker thread and handed back through the SDL
+ * event queue (SDL_USEREVENT, code PREFETCH_EVENT_CODE) to be parked in the
+ * listing cache, so pressing A finds it ready. Only one prefetch runs at a
+ * time, moving the selection cancels it, and directories the library index
+ * or cache can already serve are skipped.
+ */
+
+#define PREFETCH_EVENT_CODE 3
+#define PREFETCH_DWELL_MS   300
+// Bigger directories are left to the background scanner
+#define PREFETCH_MAX_ENTRIES 4096
+
+typedef struct {
+    char path[MAX_PATH_LEN];
+    DirContent *content;
+} PrefetchResult;
+
+/**
+ * Sets the directory the selection is resting on, or NULL if it is not on
+ * a directory. A different target cancels any prefetch in flight and
+ * restarts the dwell timer.
+ */
+void prefetch_request(const char* path);
+
+/**
+ * Starts the pending prefetch once its target has been highlighted for
+ * PREFETCH_DWELL_MS. Called from the main loop.
+ */
+void prefetch_update(void);
+
+/**
+ * Returns the milliseconds until prefetch_update() has a prefetch to start,
+ * or UINT32_MAX if none is waiting.
+ */
+Uint32 prefetch_wait(void);
+
+/**
+ * Takes a result delivered by a PREFETCH_EVENT_CODE event, parking the
+ * listing in the cache.
+ */
+void prefetch_accept(PrefetchResult* result);
+
+/**
+ * Cancels any prefetch and waits for its worker thread to exit.
+ */
+void prefetch_shutdown(void);
+
+#endif // PREFETCH_H
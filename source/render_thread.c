@@ -0,0 +1,335 @@
+#include <string.h>
+#include "render_thread.h"
+#include "frame.h"
+#include "browser.h"
+#include "list_view.h"
+#include "glyph_atlas.h"
+#include "text_cache.h"
+#include "headless.h"
+#include "input.h"
+#include "perf.h"
+#include "perf_hud.h"
+#include "config.h"
+#include "logging.h"
+#include <SDL_thread.h>
+
+#define STATUS_TEXT "- MENU    + QUIT    X BROWSE/FAVES/HISTORY    Y TOGGLE FAVORITE"
+
+// Shortest time between frames on a display, about one 60 Hz refresh
+#define FRAME_INTERVAL_MS 16
+
+static SDL_Thread* thread = NULL;
+static SDL_sem* started = NULL;
+static int start_result = 0;
+static SDL_atomic_t running;
+static SDL_atomic_t targets_lost;
+
+static SDL_Window* window = NULL;
+static TTF_Font* list_font = NULL;
+static TTF_Font* status_font = NULL;
+
+// Box art and grid tiles posted by the main thread and not uploaded yet
+static SDL_mutex* box_art_lock = NULL;
+static SDL_Surface* box_art_pending = NULL;
+static int box_art_pending_id = 0;
+static GridTile* tiles_pending[GRID_SLOTS];
+
+// Render thread only
+static SDL_Renderer* renderer = NULL;
+static SDL_Texture* box_art_texture = NULL;
+static SDL_Rect box_art_rect;
+static int box_art_id = 0;
+
+// Turns the newest posted box art surface into the box art texture
+static void upload_box_art(void) {
+    SDL_LockMutex(box_art_lock);
+    SDL_Surface* surface = box_art_pending;
+    int id = box_art_pending_id;
+    box_art_pending = NULL;
+    SDL_UnlockMutex(box_art_lock);
+    if (!surface) return;
+
+    if (box_art_texture) {
+        SDL_DestroyTexture(box_art_texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+    }
+    box_art_texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (box_art_texture) perf_count(PERF_TEXTURES_ALIVE, 1);
+    box_art_id = id;
+
+    float aspect = (float)surface->w / surface->h;
+    box_art_rect.w = BOXART_MAX_WIDTH;
+    box_art_rect.h = (int)(BOXART_MAX_WIDTH / aspect);
+    box_art_rect.x = SCREEN_W - box_art_rect.w - 20;
+    box_art_rect.y = (SCREEN_H - box_art_rect.h) / 2;
+    SDL_FreeSurface(surface);
+}
+
+// Uploads every grid tile posted since the last frame
+static void upload_tiles(void) {
+    GridTile* tiles[GRID_SLOTS];
+    SDL_LockMutex(box_art_lock);
+    memcpy(tiles, tiles_pending, sizeof(tiles));
+    memset(tiles_pending, 0, sizeof(tiles_pending));
+    SDL_UnlockMutex(box_art_lock);
+
+    for (int i = 0; i < GRID_SLOTS; i++) {
+        if (tiles[i]) grid_view_upload(renderer, tiles[i]);
+    }
+}
+
+// Takes text from the text cache, centered across the screen; the caller
+// sets rect->y and draws it with draw_text()
+static SDL_Texture* centered_text(const char* text, TTF_Font* font, SDL_Color color, SDL_Rect* rect) {
+    SDL_Texture* texture = text_cache_acquire(renderer, text, font, color, rect);
+    if (texture) rect->x = (SCREEN_W - rect->w) / 2;
+    return texture;
+}
+
+static void draw_text(SDL_Texture* texture, const SDL_Rect* rect) {
+    SDL_RenderCopy(renderer, texture, NULL, rect);
+    text_cache_release(texture);
+}
+
+static void draw_menu(int selection) {
+    int bar = get_highlight_mode() == HIGHLIGHT_BAR;
+    for (int i = 0; i < MENU_OPTIONS; i++) {
+        SDL_Color color = (i == selection && !bar) ? COLOR_TEXT_SELECTED : COLOR_TEXT;
+        SDL_Rect rect;
+        SDL_Texture* text = centered_text(menu_options[i], list_font, color, &rect);
+        if (!text) continue;
+        rect.y = SCREEN_H / 3 + i * 60;
+        if (i == selection && bar) draw_selection_bar(renderer, &rect);
+        draw_text(text, &rect);
+    }
+}
+
+// Draws and presents a frame
+// Returns 1 if it is still changing (scrolling, or rows left to draw) and
+// should be drawn again
+static int draw_frame(const Frame* frame) {
+    perf_render_begin();
+    int unfinished = 0;
+
+    // Some renderers lose the contents of target textures
+    if (SDL_AtomicSet(&targets_lost, 0)) list_view_clear();
+    upload_box_art();
+    upload_tiles();
+
+    SDL_SetRenderDrawColor(renderer,
+        COLOR_BACKGROUND.r,
+        COLOR_BACKGROUND.g,
+        COLOR_BACKGROUND.b,
+        COLOR_BACKGROUND.a);
+    SDL_RenderClear(renderer);
+
+    // Draw semi-transparent background if a notification is showing
+    if (frame->notification[0]) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderFillRect(renderer, NULL);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    }
+
+    // Render directory and file listings, menu, or scraping message
+    SDL_Rect rect;
+    SDL_Texture* text;
+    if (frame->view == FRAME_VIEW_SCRAPING) {
+        text = centered_text("Press B to stop", list_font, COLOR_TEXT, &rect);
+        if (text) {
+            rect.y = (SCREEN_H - rect.h) / 2;
+            draw_text(text, &rect);
+        }
+    } else if (frame->view == FRAME_VIEW_MENU) {
+        draw_menu(frame->menu_selection);
+    } else if (frame->view == FRAME_VIEW_GRID) {
+        draw_grid(renderer, list_font, &frame->listing, frame->grid_top_row);
+    } else {
+        unfinished = draw_listing(renderer, list_font, &frame->listing);
+
+        // Box art once the texture for the one asked for has arrived
+        if (box_art_texture && frame->box_art != 0 && frame->box_art == box_art_id) {
+            SDL_RenderCopy(renderer, box_art_texture, NULL, &box_art_rect);
+        }
+    }
+
+    // Render notification if active
+    if (frame->notification[0]) {
+        text = centered_text(frame->notification, list_font, COLOR_TEXT_ERROR, &rect);
+        if (text) {
+            rect.y = SCREEN_H - rect.h - 20;
+            draw_text(text, &rect);
+        }
+    }
+
+    // Render status bar
+    SDL_Rect status_bar = {0, SCREEN_H - STATUS_BAR_HEIGHT, SCREEN_W, STATUS_BAR_HEIGHT};
+    SDL_SetRenderDrawColor(renderer,
+        COLOR_STATUS_BAR.r,
+        COLOR_STATUS_BAR.g,
+        COLOR_STATUS_BAR.b,
+        COLOR_STATUS_BAR.a);
+    SDL_RenderFillRect(renderer, &status_bar);
+
+    text = centered_text(STATUS_TEXT, status_font, COLOR_STATUS_TEXT, &rect);
+    if (text) {
+        rect.y = SCREEN_H - STATUS_BAR_HEIGHT + (STATUS_BAR_HEIGHT - rect.h) / 2;
+        draw_text(text, &rect);
+    }
+
+    perf_hud_draw(renderer, status_font, &frame->listing);
+
+    SDL_RenderPresent(renderer);
+    perf_frame_end();
+    return unfinished;
+}
+
+// Everything the renderer made has to go before it does
+static void release_textures(void) {
+    if (box_art_texture) {
+        SDL_DestroyTexture(box_art_texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+        box_art_texture = NULL;
+    }
+    glyph_atlas_shutdown();
+    text_cache_clear();
+    list_view_clear();
+    grid_view_clear();
+}
+
+static int render_loop(void* data __attribute__((unused))) {
+    renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE) :
+                        headless_create_renderer();
+    start_result = renderer != NULL;
+    if (renderer) {
+        log_message(LOG_DEBUG, "SDL renderer created");
+    } else {
+        log_message(LOG_ERROR, "Renderer creation failed: %s", SDL_GetError());
+    }
+    SDL_SemPost(started);
+    if (!renderer) return 1;
+
+    const Frame* frame = NULL;
+    int dirty = 0;          // frame is new, or still changing, since it was drawn
+    Uint32 last_drawn = 0;
+    while (SDL_AtomicGet(&running)) {
+        const Frame* latest = frame_take();
+        if (latest) {
+            frame = latest;
+            dirty = 1;
+        }
+
+        if (!dirty) {
+            // The screen is up to date: build the pages either side of the
+            // listing a row at a time, looking for a new frame between rows,
+            // then sleep until there is more to show
+            if (frame && frame->view == FRAME_VIEW_LISTING &&
+                prerender_listing(renderer, list_font, &frame->listing)) {
+                continue;
+            }
+            frame_wait(IDLE_WAIT_MS);
+            continue;
+        }
+
+        // The software renderer doesn't wait for vsync, so a scrolling list
+        // would be redrawn back to back; wait for the next refresh instead,
+        // taking any newer frame published meanwhile. Headless frames are
+        // not shown and are drawn as fast as they come.
+        Uint32 since = SDL_GetTicks() - last_drawn;
+        if (window && since < FRAME_INTERVAL_MS) {
+            frame_wait(FRAME_INTERVAL_MS - since);
+            continue;
+        }
+
+        dirty = draw_frame(frame);
+        frame_drawn();
+        last_drawn = SDL_GetTicks();
+    }
+
+    release_textures();
+    SDL_DestroyRenderer(renderer);
+    renderer = NULL;
+    return 0;
+}
+
+int render_thread_start(SDL_Window* target, TTF_Font* font, TTF_Font* small_font) {
+    window = target;
+    list_font = font;
+    status_font = small_font;
+
+    started = SDL_CreateSemaphore(0);
+    box_art_lock = SDL_CreateMutex();
+    if (!started || !box_art_lock || !frame_init()) {
+        log_message(LOG_ERROR, "Couldn't create render thread locks: %s", SDL_GetError());
+        return 0;
+    }
+
+    SDL_AtomicSet(&running, 1);
+    thread = SDL_CreateThread(render_loop, "Render", NULL);
+    if (!thread) {
+        log_message(LOG_ERROR, "Couldn't start render thread: %s", SDL_GetError());
+        return 0;
+    }
+
+    SDL_SemWait(started);
+    return start_result;
+}
+
+void render_thread_post_box_art(SDL_Surface* surface, int id) {
+    if (!box_art_lock) {
+        SDL_FreeSurface(surface);
+        return;
+    }
+
+    SDL_LockMutex(box_art_lock);
+    SDL_Surface* replaced = box_art_pending;
+    box_art_pending = surface;
+    box_art_pending_id = id;
+    SDL_UnlockMutex(box_art_lock);
+    if (replaced) SDL_FreeSurface(replaced);
+}
+
+void render_thread_post_tile(GridTile* tile) {
+    if (!box_art_lock) {
+        grid_view_free_tile(tile);
+        return;
+    }
+
+    SDL_LockMutex(box_art_lock);
+    GridTile** pending = &tiles_pending[tile->index % GRID_SLOTS];
+    GridTile* replaced = *pending;
+    *pending = tile;
+    SDL_UnlockMutex(box_art_lock);
+    grid_view_free_tile(replaced);
+}
+
+void render_thread_targets_reset(void) {
+    SDL_AtomicSet(&targets_lost, 1);
+}
+
+void render_thread_stop(void) {
+    if (thread) {
+        SDL_AtomicSet(&running, 0);
+        frame_wake();
+        SDL_WaitThread(thread, NULL);
+        thread = NULL;
+    }
+    frame_shutdown();
+
+    if (box_art_pending) {
+        SDL_FreeSurface(box_art_pending);
+        box_art_pending = NULL;
+    }
+    for (int i = 0; i < GRID_SLOTS; i++) {
+        grid_view_free_tile(tiles_pending[i]);
+        tiles_pending[i] = NULL;
+    }
+    if (box_art_lock) {
+        SDL_DestroyMutex(box_art_lock);
+        box_art_lock = NULL;
+    }
+    if (started) {
+        SDL_DestroySemaphore(started);
+        started = NULL;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "grid_view.h"
+
+/**
+ * Render thread.
+ *
+ * The renderer and every texture belong to a thread of their own. The main
+ * thread polls input, runs the browser and publishes what should be on
+ * screen as a Frame (see frame.h); the render thread draws the newest frame
+ * and presents it, keeps drawing while the list scrolls or has rows left to
+ * fill within its per-frame budget (see list_view.h), at most once per
+ * display refresh, and otherwise
+ * pre-renders the listing's neighbouring pages and then sleeps until the
+ * next frame is published. A slow present or text
+ * rasterisation therefore never holds up input, and the main thread never
+ * touches the renderer.
+ */
+
+/**
+ * Starts the render thread, which creates a renderer for window, or a
+ * headless one if window is NULL, and draws with font and small_font.
+ * Waits only until the renderer has been created.
+ *
+ * @return 1 if the thread is running, 0 if the renderer could not be created
+ */
+int render_thread_start(SDL_Window* window, TTF_Font* font, TTF_Font* small_font);
+
+/**
+ * Hands a loaded box art surface to the render thread, which uploads it as
+ * the texture shown by frames asking for box art id, then frees it. A
+ * surface still waiting to be uploaded is replaced.
+ */
+void render_thread_post_box_art(SDL_Surface* surface, int id);
+
+/**
+ * Hands a grid tile to the render thread, which uploads it into its slot
+ * and frees it. A tile still waiting for the same slot is replaced, so at
+ * most GRID_SLOTS tiles are ever pending.
+ */
+void render_thread_post_tile(GridTile* tile);
+
+/**
+ * Tells the render thread its render target textures were lost
+ * (SDL_RENDER_TARGETS_RESET).
+ */
+void render_thread_targets_reset(void);
+
+/**
+ * Stops the render thread, which releases every texture and destroys the
+ * renderer before exiting. Safe to call if it never started.
+ */
+void render_thread_stop(void);
+
+#endif // RENDER_THREAD_H
@@ -0,0 +1,161 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL.h>
+#include <SDL_thread.h>
+#include "scanner.h"
+#include "browser.h"
+#include "logging.h"
+#include "dir_cache.h"
+
+typedef struct {
+    char path[MAX_PATH_LEN];
+    int generation;
+    int64_t mtime;
+} ScanRequest;
+
+// Bumped by the main thread to start or cancel a scan; workers poll it
+static SDL_atomic_t scan_generation;
+static SDL_Thread* scan_thread = NULL;
+
+// Main thread only: whether the current scan's last batch has arrived
+static int scan_finished = 1;
+
+static int scan_cancelled(const ScanRequest* req) {
+    return SDL_AtomicGet(&scan_generation) != req->generation;
+}
+
+static ScanBatch* create_batch(const ScanRequest* req) {
+    ScanBatch* batch = malloc(sizeof(ScanBatch));
+    if (!batch) return NULL;
+
+    batch->entries = dir_content_create();
+    if (!batch->entries) {
+        free(batch);
+        return NULL;
+    }
+    batch->generation = req->generation;
+    batch->done = 0;
+    batch->mtime = req->mtime;
+    return batch;
+}
+
+static void push_batch(ScanBatch* batch) {
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    event.user.code = SCANNER_EVENT_CODE;
+    event.user.data1 = batch;
+    if (SDL_PushEvent(&event) != 1) {
+        log_message(LOG_ERROR, "Could not queue scan batch: %s", SDL_GetError());
+        scanner_free_batch(batch);
+    }
+}
+
+static int scan_thread_fn(void* data) {
+    ScanRequest* req = (ScanRequest*)data;
+    ScanBatch* batch = NULL;
+    int limit = ENTRIES_PER_PAGE;
+    Uint32 batch_started = 0;
+
+    req->mtime = dir_cache_stamp(req->path);
+    DIR* dir = opendir(req->path);
+    if (!dir) {
+        log_message(LOG_INFO, "Scanner failed to open directory: %s", req->path);
+    }
+
+    struct dirent* entry;
+    while (dir && !scan_cancelled(req) && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        if (!batch) {
+            batch = create_batch(req);
+            if (!batch) break;
+            batch_started = SDL_GetTicks();
+        }
+
+        size_t len = strlen(entry->d_name);
+        int added = entry->d_type == DT_DIR ?
+            dir_content_add_dir(batch->entries, entry->d_name, len) :
+            dir_content_add_file(batch->entries, entry->d_name, len);
+        if (!added) {
+            log_message(LOG_ERROR, "Out of memory scanning %s", req->path);
+            break;
+        }
+
+        int count = batch->entries->dir_count + batch->entries->file_count;
+        if (count >= limit || SDL_GetTicks() - batch_started >= SCANNER_FLUSH_MS) {
+            push_batch(batch);
+            batch = NULL;
+            if (limit < SCANNER_MAX_BATCH) limit *= 2;
+        }
+    }
+    if (dir) closedir(dir);
+
+    // The last batch, possibly empty, tells the main loop the scan is over
+    if (scan_cancelled(req)) {
+        if (batch) scanner_free_batch(batch);
+    } else {
+        if (!batch) batch = create_batch(req);
+        if (batch) {
+            batch->done = 1;
+            push_batch(batch);
+        }
+    }
+
+    free(req);
+    return 0;
+}
+
+int scanner_start(const char* path) {
+    scanner_shutdown();
+
+    ScanRequest* req = malloc(sizeof(ScanRequest));
+    if (!req) return 0;
+
+    strncpy(req->path, path, MAX_PATH_LEN - 1);
+    req->path[MAX_PATH_LEN - 1] = '\0';
+    req->generation = SDL_AtomicGet(&scan_generation);
+
+    scan_thread = SDL_CreateThread(scan_thread_fn, "DirScanner", req);
+    if (!scan_thread) {
+        log_message(LOG_ERROR, "Could not start scanner thread: %s", SDL_GetError());
+        free(req);
+        return 0;
+    }
+
+    scan_finished = 0;
+    log_message(LOG_INFO, "Scanning %s in the background", path);
+    return 1;
+}
+
+void scanner_cancel(void) {
+    SDL_AtomicAdd(&scan_generation, 1);
+    scan_finished = 1;
+}
+
+int scanner_accept(const ScanBatch* batch) {
+    if (!batch || batch->generation != SDL_AtomicGet(&scan_generation)) return 0;
+    if (batch->done) scan_finished = 1;
+    return 1;
+}
+
+int scanner_active(void) {
+    return !scan_finished;
+}
+
+void scanner_free_batch(ScanBatch* batch) {
+    if (!batch) return;
+    free_dir_content(batch->entries);
+    free(batch);
+}
+
+void scanner_shutdown(void) {
+    scanner_cancel();
+    if (scan_thread) {
+        SDL_WaitThread(scan_thread, NULL);
+        scan_thread = NULL;
+    }
+}
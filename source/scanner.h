@@ -0,0 +1,59 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "dir_content.h"
+
+/**
+ * Background directory scanner.
+ *
+ * Reads a directory on a worker thread and hands its entries to the main
+ * loop in batches, each pushed as an SDL_USEREVENT with code
+ * SCANNER_EVENT_CODE and the ScanBatch as data1. The first batch is one
+ * page long so something can be drawn straight away; later batches double
+ * in size up to SCANNER_MAX_BATCH, or are flushed early if the directory is
+ * slow to read.
+ */
+
+#define SCANNER_EVENT_CODE 2
+#define SCANNER_MAX_BATCH  4096
+#define SCANNER_FLUSH_MS   100
+
+typedef struct {
+    DirContent *entries;    // Unsorted entries read since the previous batch
+    int generation;         // Scan the batch belongs to
+    int done;               // Set on the last batch of a scan
+    int64_t mtime;          // Directory mtime stamped when the scan started
+} ScanBatch;
+
+/**
+ * Starts scanning path, cancelling any scan already running.
+ *
+ * @return 1 if the worker thread was started, 0 otherwise
+ */
+int scanner_start(const char* path);
+
+/**
+ * Cancels the running scan, if any. Batches it already queued are rejected
+ * by scanner_accept().
+ */
+void scanner_cancel(void);
+
+/**
+ * Returns 1 if batch belongs to the current scan and should be applied.
+ * Marks the scan finished when batch is its last one.
+ */
+int scanner_accept(const ScanBatch* batch);
+
+/**
+ * Returns 1 while a scan has batches still to deliver.
+ */
+int scanner_active(void);
+
+void scanner_free_batch(ScanBatch* batch);
+
+/**
+ * Cancels any scan and waits for its worker thread to exit.
+ */
+void scanner_shutdown(void);
+
+#endif // SCANNER_H
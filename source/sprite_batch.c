@@ -0,0 +1,83 @@
+#include "sprite_batch.h"
+
+void sprite_batch_begin(SpriteBatch* batch, SDL_Renderer* renderer, SDL_Texture* texture, SDL_Color color) {
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+    batch->renderer = renderer;
+    batch->texture = texture;
+    batch->color = color;
+    batch->texture_w = w > 0 ? (float)w : 1.0f;
+    batch->texture_h = h > 0 ? (float)h : 1.0f;
+    batch->count = 0;
+}
+
+void sprite_batch_add(SpriteBatch* batch, const SDL_Rect* src, const SDL_Rect* dst) {
+    if (batch->count == SPRITE_BATCH_MAX) sprite_batch_end(batch);
+    batch->src[batch->count] = *src;
+    batch->dst[batch->count] = *dst;
+    batch->count++;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+// Two triangles per quad over its corners in the order top-left, top-right,
+// bottom-left, bottom-right; the same for every batch, so built once
+static int quad_indices[SPRITE_BATCH_MAX * 6];
+static int indices_ready = 0;
+
+static int draw_geometry(SpriteBatch* batch) {
+    static SDL_Vertex vertices[SPRITE_BATCH_MAX * 4];
+
+    if (!indices_ready) {
+        for (int i = 0; i < SPRITE_BATCH_MAX; i++) {
+            int* quad = &quad_indices[i * 6];
+            quad[0] = i * 4;
+            quad[1] = i * 4 + 1;
+            quad[2] = i * 4 + 2;
+            quad[3] = i * 4 + 2;
+            quad[4] = i * 4 + 1;
+            quad[5] = i * 4 + 3;
+        }
+        indices_ready = 1;
+    }
+
+    for (int i = 0; i < batch->count; i++) {
+        const SDL_Rect* src = &batch->src[i];
+        const SDL_Rect* dst = &batch->dst[i];
+        float u0 = src->x / batch->texture_w, u1 = (src->x + src->w) / batch->texture_w;
+        float v0 = src->y / batch->texture_h, v1 = (src->y + src->h) / batch->texture_h;
+        float x0 = (float)dst->x, x1 = (float)(dst->x + dst->w);
+        float y0 = (float)dst->y, y1 = (float)(dst->y + dst->h);
+
+        SDL_Vertex* corner = &vertices[i * 4];
+        corner[0] = (SDL_Vertex){ { x0, y0 }, batch->color, { u0, v0 } };
+        corner[1] = (SDL_Vertex){ { x1, y0 }, batch->color, { u1, v0 } };
+        corner[2] = (SDL_Vertex){ { x0, y1 }, batch->color, { u0, v1 } };
+        corner[3] = (SDL_Vertex){ { x1, y1 }, batch->color, { u1, v1 } };
+    }
+
+    // Vertex colours carry the tint, so the texture's own colour mod is
+    // left neutral in case the renderer applies both
+    SDL_SetTextureColorMod(batch->texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(batch->texture, 255);
+    return SDL_RenderGeometry(batch->renderer, batch->texture, vertices, batch->count * 4,
+                              quad_indices, batch->count * 6) == 0;
+}
+#endif
+
+int sprite_batch_end(SpriteBatch* batch) {
+    if (batch->count == 0) return 0;
+
+    int batched = 0;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    batched = draw_geometry(batch);
+#endif
+    if (!batched) {
+        SDL_SetTextureColorMod(batch->texture, batch->color.r, batch->color.g, batch->color.b);
+        SDL_SetTextureAlphaMod(batch->texture, batch->color.a);
+        for (int i = 0; i < batch->count; i++) {
+            SDL_RenderCopy(batch->renderer, batch->texture, &batch->src[i], &batch->dst[i]);
+        }
+    }
+    batch->count = 0;
+    return batched;
+}
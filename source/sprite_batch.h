@@ -0,0 +1,48 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL.h>
+
+/**
+ * Batched drawing of sub-rects of one texture.
+ *
+ * Quads added between sprite_batch_begin() and sprite_batch_end() go to the
+ * renderer as a single SDL_RenderGeometry call, so a run of glyphs or a page
+ * of row slots costs one trip through the renderer instead of one
+ * SDL_RenderCopy each. With SDL older than 2.0.18, or if the renderer
+ * rejects the geometry, the quads are drawn with SDL_RenderCopy instead.
+ * Render thread only.
+ */
+
+#define SPRITE_BATCH_MAX 256    // Quads per call; a full batch is flushed early
+
+typedef struct {
+    SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    SDL_Color color;
+    float texture_w;
+    float texture_h;
+    int count;
+    SDL_Rect src[SPRITE_BATCH_MAX];
+    SDL_Rect dst[SPRITE_BATCH_MAX];
+} SpriteBatch;
+
+/**
+ * Starts a batch drawing from texture, tinted with color.
+ */
+void sprite_batch_begin(SpriteBatch* batch, SDL_Renderer* renderer, SDL_Texture* texture, SDL_Color color);
+
+/**
+ * Queues src of the texture to be drawn at dst.
+ */
+void sprite_batch_add(SpriteBatch* batch, const SDL_Rect* src, const SDL_Rect* dst);
+
+/**
+ * Draws everything queued since the batch began or was last flushed.
+ *
+ * @return 1 if it went out as geometry, 0 if it fell back to SDL_RenderCopy
+ *         or there was nothing to draw
+ */
+int sprite_batch_end(SpriteBatch* batch);
+
+#endif // SPRITE_BATCH_H
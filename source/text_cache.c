@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include <string.h>
+#include "text_cache.h"
+#include "browser.h"
+#include "perf.h"
+#include "uthash.h"
+
+typedef struct {
+    SDL_Texture* texture;
+    int w;
+    int h;
+    size_t bytes;
+    int refs;                   // Holders that have not released it yet
+    UT_hash_handle hh;          // By key, least recently used first
+    UT_hash_handle hh_texture;  // By texture, for text_cache_release()
+    size_t key_length;
+    char key[];                 // Font pointer, colour, then the text
+} CachedText;
+
+static CachedText* cache = NULL;
+static CachedText* cache_by_texture = NULL;
+static size_t cached_bytes = 0;
+
+// Where lookup keys are built, so a hit allocates nothing. It only grows,
+// to the longest key seen.
+static char* scratch = NULL;
+static size_t scratch_size = 0;
+
+static void remove_text(CachedText* item) {
+    HASH_DELETE(hh, cache, item);
+    HASH_DELETE(hh_texture, cache_by_texture, item);
+    cached_bytes -= item->bytes;
+    SDL_DestroyTexture(item->texture);
+    perf_count(PERF_TEXTURES_ALIVE, -1);
+    free(item);
+}
+
+// Evicts unheld textures, least recently used first, until within budget
+static void evict(void) {
+    CachedText *item, *tmp;
+    HASH_ITER(hh, cache, item, tmp) {
+        if (cached_bytes <= TEXT_CACHE_MAX_BYTES) break;
+        if (item->refs == 0) remove_text(item);
+    }
+}
+
+SDL_Texture* text_cache_acquire(SDL_Renderer* renderer, const char* text, TTF_Font* font,
+                                SDL_Color color, SDL_Rect* rect) {
+    size_t text_length = strlen(text);
+    size_t key_length = sizeof(font) + sizeof(color) + text_length;
+    if (key_length > scratch_size) {
+        char* grown = realloc(scratch, key_length);
+        if (!grown) return NULL;
+        scratch = grown;
+        scratch_size = key_length;
+    }
+    memcpy(scratch, &font, sizeof(font));
+    memcpy(scratch + sizeof(font), &color, sizeof(color));
+    memcpy(scratch + sizeof(font) + sizeof(color), text, text_length);
+
+    CachedText* found;
+    HASH_FIND(hh, cache, scratch, key_length, found);
+    if (found) {
+        // Re-adding moves it to the most recently used end
+        HASH_DELETE(hh, cache, found);
+        HASH_ADD_KEYPTR(hh, cache, found->key, found->key_length, found);
+        found->refs++;
+        rect->w = found->w;
+        rect->h = found->h;
+        return found->texture;
+    }
+
+    CachedText* item = malloc(sizeof(CachedText) + key_length);
+    if (!item) return NULL;
+    memcpy(item->key, scratch, key_length);
+    item->key_length = key_length;
+
+    item->texture = render_text(renderer, text, font, color, rect);
+    if (!item->texture) {
+        free(item);
+        return NULL;
+    }
+    item->w = rect->w;
+    item->h = rect->h;
+    item->bytes = (size_t)rect->w * rect->h * 4;
+    item->refs = 1;
+    HASH_ADD_KEYPTR(hh, cache, item->key, item->key_length, item);
+    HASH_ADD(hh_texture, cache_by_texture, texture, sizeof(SDL_Texture*), item);
+    cached_bytes += item->bytes;
+
+    evict();
+    return item->texture;
+}
+
+void text_cache_release(SDL_Texture* texture) {
+    if (!texture) return;
+
+    CachedText* item;
+    HASH_FIND(hh_texture, cache_by_texture, &texture, sizeof(SDL_Texture*), item);
+    if (!item) {
+        SDL_DestroyTexture(texture);
+        perf_count(PERF_TEXTURES_ALIVE, -1);
+        return;
+    }
+    if (item->refs > 0) item->refs--;
+    evict();
+}
+
+size_t text_cache_bytes(void) {
+    return cached_bytes;
+}
+
+void text_cache_clear(void) {
+    while (cache) remove_text(cache);
+    free(scratch);
+    scratch = NULL;
+    scratch_size = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+/**
+ * Cache of rendered text textures keyed by text, font and colour.
+ *
+ * Text drawn again with the same font and colour, such as menu items as the
+ * highlight moves between them, reuses the texture rendered the first time.
+ * Textures are reference counted: the cache only evicts textures nobody
+ * holds, least recently used first, once it is over TEXT_CACHE_MAX_BYTES.
+ */
+
+#define TEXT_CACHE_MAX_BYTES (2 * 1024 * 1024)
+
+/**
+ * Returns a texture of text rendered in font and color, rendering it only
+ * if it is not cached, and sets rect's size to the texture's. The texture
+ * belongs to the cache and must be given back with text_cache_release().
+ *
+ * @return The texture, or NULL if rendering fails
+ */
+SDL_Texture* text_cache_acquire(SDL_Renderer* renderer, const char* text, TTF_Font* font,
+                                SDL_Color color, SDL_Rect* rect);
+
+/**
+ * Gives back a texture from text_cache_acquire(). Textures the cache does
+ * not know are destroyed.
+ */
+void text_cache_release(SDL_Texture* texture);
+
+/**
+ * Returns the bytes of texture memory the cache is holding.
+ */
+size_t text_cache_bytes(void);
+
+/**
+ * Destroys every cached texture, including ones still held.
+ */
+void text_cache_clear(void);
+
+#endif // TEXT_CACHE_H
@@ -0,0 +1,35 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../source/browser.h"
+
+int mock_render_count = 0;
+
+// Mock implementation of render_text: a fake texture sized 10x20 pixels
+// per character, so tests can count rasterisations without SDL_ttf
+SDL_Texture* render_text(SDL_Renderer *renderer __attribute__((unused)), const char* text,
+                         TTF_Font *font __attribute__((unused)),
+                         const SDL_Color color __attribute__((unused)), SDL_Rect *rect) {
+    mock_render_count++;
+    rect->w = (int)strlen(text) * 10;
+    rect->h = 20;
+    return (SDL_Texture*)malloc(1);
+}
+
+// No favorites in tests
+int is_favorite(const char *path __attribute__((unused))) {
+    return 0;
+}
+
+// Grid loads are counted and the first MOCK_GRID_LOADS indices kept;
+// mock_grid_load_result says whether a loader "started"
+#define MOCK_GRID_LOADS 64
+int mock_grid_loads = 0;
+int mock_grid_load_result = 1;
+int mock_grid_indices[MOCK_GRID_LOADS];
+
+int load_grid_tile(const char* rom_path __attribute__((unused)), const char* rom_name __attribute__((unused)),
+                   uint32_t revision __attribute__((unused)), int index) {
+    if (mock_grid_loads < MOCK_GRID_LOADS) mock_grid_indices[mock_grid_loads] = index;
+    mock_grid_loads++;
+    return mock_grid_load_result;
+}
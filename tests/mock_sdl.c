@@ -0,0 +1,235 @@
+#include <stdlib.h>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#define MOCK_MAX_EVENTS 256
+
+// Mock implementation of the SDL calls made by the modules under test.
+// The only textures in tests are the fake ones from mock render_text.
+void SDL_DestroyTexture(SDL_Texture* texture) {
+    free(texture);
+}
+
+// Threads run to completion inside SDL_CreateThread so tests stay
+// deterministic while still exercising the multi-threaded code paths.
+struct SDL_Thread {
+    int status;
+};
+
+int mock_cpu_count = 4;
+
+int SDL_GetCPUCount(void) {
+    return mock_cpu_count;
+}
+
+SDL_Thread* SDL_CreateThread(SDL_ThreadFunction fn, const char* name __attribute__((unused)), void* data) {
+    SDL_Thread* thread = malloc(sizeof(SDL_Thread));
+    if (!thread) return NULL;
+    thread->status = fn(data);
+    return thread;
+}
+
+void SDL_WaitThread(SDL_Thread* thread, int* status) {
+    if (!thread) return;
+    if (status) *status = thread->status;
+    free(thread);
+}
+
+// Atomics only need to be plain reads and writes while threads run inline
+int SDL_AtomicGet(SDL_atomic_t* a) {
+    return a->value;
+}
+
+int SDL_AtomicAdd(SDL_atomic_t* a, int v) {
+    int old = a->value;
+    a->value += v;
+    return old;
+}
+
+// Tests move the clock by hand
+Uint32 mock_ticks = 0;
+
+Uint32 SDL_GetTicks(void) {
+    return mock_ticks;
+}
+
+const char* SDL_GetError(void) {
+    return "mock error";
+}
+
+// Pushed events are kept for the test to inspect
+SDL_Event mock_events[MOCK_MAX_EVENTS];
+int mock_event_count = 0;
+
+int SDL_PushEvent(SDL_Event* event) {
+    if (mock_event_count >= MOCK_MAX_EVENTS) return 0;
+    mock_events[mock_event_count++] = *event;
+    return 1;
+}
+
+int SDL_AtomicSet(SDL_atomic_t* a, int v) {
+    int old = a->value;
+    a->value = v;
+    return old;
+}
+
+// The performance counter ticks in microseconds and is also moved by hand
+Uint64 mock_perf_counter = 0;
+
+Uint64 SDL_GetPerformanceCounter(void) {
+    return mock_perf_counter;
+}
+
+Uint64 SDL_GetPerformanceFrequency(void) {
+    return 1000000;
+}
+
+// Render target textures, freed by SDL_DestroyTexture
+SDL_bool mock_render_targets = SDL_TRUE;
+int mock_texture_count = 0;
+
+SDL_bool SDL_RenderTargetSupported(SDL_Renderer* renderer __attribute__((unused))) {
+    return mock_render_targets;
+}
+
+SDL_Texture* SDL_CreateTexture(SDL_Renderer* renderer __attribute__((unused)),
+                               Uint32 format __attribute__((unused)), int access __attribute__((unused)),
+                               int w __attribute__((unused)), int h __attribute__((unused))) {
+    mock_texture_count++;
+    return (SDL_Texture*)malloc(1);
+}
+
+SDL_Texture* SDL_CreateTextureFromSurface(SDL_Renderer* renderer __attribute__((unused)),
+                                          SDL_Surface* surface __attribute__((unused))) {
+    mock_texture_count++;
+    return (SDL_Texture*)malloc(1);
+}
+
+void SDL_FreeSurface(SDL_Surface* surface) {
+    free(surface);
+}
+
+int SDL_SetTextureBlendMode(SDL_Texture* texture __attribute__((unused)),
+                            SDL_BlendMode mode __attribute__((unused))) {
+    return 0;
+}
+
+// Drawing calls only need to succeed
+SDL_Texture* mock_render_target = NULL;
+
+SDL_Texture* SDL_GetRenderTarget(SDL_Renderer* renderer __attribute__((unused))) {
+    return mock_render_target;
+}
+
+int SDL_SetRenderTarget(SDL_Renderer* renderer __attribute__((unused)), SDL_Texture* texture) {
+    mock_render_target = texture;
+    return 0;
+}
+
+int SDL_SetRenderDrawBlendMode(SDL_Renderer* renderer __attribute__((unused)),
+                               SDL_BlendMode mode __attribute__((unused))) {
+    return 0;
+}
+
+int SDL_SetRenderDrawColor(SDL_Renderer* renderer __attribute__((unused)), Uint8 r __attribute__((unused)),
+                           Uint8 g __attribute__((unused)), Uint8 b __attribute__((unused)),
+                           Uint8 a __attribute__((unused))) {
+    return 0;
+}
+
+int SDL_RenderFillRect(SDL_Renderer* renderer __attribute__((unused)),
+                       const SDL_Rect* rect __attribute__((unused))) {
+    return 0;
+}
+
+int SDL_RenderFillRects(SDL_Renderer* renderer __attribute__((unused)),
+                        const SDL_Rect* rects __attribute__((unused)), int count __attribute__((unused))) {
+    return 0;
+}
+
+// Copies and geometry are counted; mock_geometry_result makes the renderer
+// reject geometry as old SDL versions would
+int mock_copy_calls = 0;
+int mock_geometry_calls = 0;
+int mock_geometry_result = 0;
+int mock_geometry_vertices = 0;
+SDL_Vertex mock_geometry_first;
+int mock_texture_w = 64;
+int mock_texture_h = 32;
+
+int SDL_RenderCopy(SDL_Renderer* renderer __attribute__((unused)), SDL_Texture* texture __attribute__((unused)),
+                   const SDL_Rect* src __attribute__((unused)), const SDL_Rect* dst __attribute__((unused))) {
+    mock_copy_calls++;
+    return 0;
+}
+
+int SDL_RenderGeometry(SDL_Renderer* renderer __attribute__((unused)), SDL_Texture* texture __attribute__((unused)),
+                       const SDL_Vertex* vertices, int num_vertices,
+                       const int* indices __attribute__((unused)), int num_indices __attribute__((unused))) {
+    mock_geometry_calls++;
+    if (vertices) mock_geometry_first = vertices[0];
+    mock_geometry_vertices = num_vertices;
+    return mock_geometry_result;
+}
+
+int SDL_QueryTexture(SDL_Texture* texture __attribute__((unused)), Uint32* format __attribute__((unused)),
+                     int* access __attribute__((unused)), int* w, int* h) {
+    if (w) *w = mock_texture_w;
+    if (h) *h = mock_texture_h;
+    return 0;
+}
+
+int SDL_SetTextureColorMod(SDL_Texture* texture __attribute__((unused)), Uint8 r __attribute__((unused)),
+                           Uint8 g __attribute__((unused)), Uint8 b __attribute__((unused))) {
+    return 0;
+}
+
+int SDL_SetTextureAlphaMod(SDL_Texture* texture __attribute__((unused)), Uint8 a __attribute__((unused))) {
+    return 0;
+}
+
+// Locks are never contended while threads run inline, and a timed wait
+// returns at once as if it had timed out
+struct SDL_mutex {
+    int locked;
+};
+
+struct SDL_cond {
+    int signals;
+};
+
+SDL_mutex* SDL_CreateMutex(void) {
+    return calloc(1, sizeof(SDL_mutex));
+}
+
+int SDL_LockMutex(SDL_mutex* mutex) {
+    mutex->locked = 1;
+    return 0;
+}
+
+int SDL_UnlockMutex(SDL_mutex* mutex) {
+    mutex->locked = 0;
+    return 0;
+}
+
+void SDL_DestroyMutex(SDL_mutex* mutex) {
+    free(mutex);
+}
+
+SDL_cond* SDL_CreateCond(void) {
+    return calloc(1, sizeof(SDL_cond));
+}
+
+int SDL_CondSignal(SDL_cond* cond) {
+    cond->signals++;
+    return 0;
+}
+
+int SDL_CondWaitTimeout(SDL_cond* cond __attribute__((unused)), SDL_mutex* mutex __attribute__((unused)),
+                        Uint32 ms __attribute__((unused))) {
+    return SDL_MUTEX_TIMEDOUT;
+}
+
+void SDL_DestroyCond(SDL_cond* cond) {
+    free(cond);
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../source/collation.h"
+
+// Test function prototypes
+int test_collation_order();
+int test_collation_parallel_sort();
+
+extern int mock_cpu_count;
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_sorted(const char* test_name, const char** names, int count, const char** expected) {
+    CollationSet set;
+    size_t names_size = 0;
+    for (int i = 0; i < count; i++) names_size += strlen(names[i]);
+
+    if (!collation_set_init(&set, count, names_size)) {
+        printf("✗ %s: Allocation failed\n", test_name);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        collation_set_add(&set, names[i], strlen(names[i]), i);
+    }
+    collation_set_sort(&set);
+
+    for (int i = 0; i < count; i++) {
+        const char* actual = names[set.items[i].index];
+        if (strcmp(actual, expected[i]) != 0) {
+            printf("✗ %s: Expected '%s' at %d but got '%s'\n", test_name, expected[i], i, actual);
+            collation_set_free(&set);
+            return 1;
+        }
+    }
+
+    printf("✓ %s\n", test_name);
+    collation_set_free(&set);
+    return 0;
+}
+
+// Test the browsing order produced by collation keys
+int test_collation_order() {
+    printf("\nTesting collation order:\n");
+    int failures = 0;
+
+    const char* case_names[] = { "Zelda", "adventure", "Metroid" };
+    const char* case_sorted[] = { "adventure", "Metroid", "Zelda" };
+    failures += assert_sorted("Case is ignored", case_names, 3, case_sorted);
+
+    const char* number_names[] = { "Game 10", "Game 2", "Game 1", "Game 02b" };
+    const char* number_sorted[] = { "Game 1", "Game 2", "Game 02b", "Game 10" };
+    failures += assert_sorted("Numbers sort by value", number_names, 4, number_sorted);
+
+    const char* article_names[] = { "The Legend of Zelda", "Kirby", "A Boy and His Blob", "Metroid", "Theme Park" };
+    const char* article_sorted[] = { "A Boy and His Blob", "Kirby", "The Legend of Zelda", "Metroid", "Theme Park" };
+    failures += assert_sorted("Leading articles ignored", article_names, 5, article_sorted);
+
+    const char* tie_names[] = { "mario", "Mario", "MARIO" };
+    const char* tie_sorted[] = { "MARIO", "Mario", "mario" };
+    failures += assert_sorted("Ties broken by raw name", tie_names, 3, tie_sorted);
+
+    return failures;
+}
+
+// Test that a listing over the threshold sorts the same split across threads
+int test_collation_parallel_sort() {
+    printf("\nTesting parallel collation sort:\n");
+    int failures = 0;
+    int count = COLLATION_PARALLEL_THRESHOLD + 1234;
+
+    char (*names)[32] = malloc(count * sizeof(*names));
+    CollationSet serial, parallel;
+    if (!names || !collation_set_init(&serial, count, count * 32) ||
+        !collation_set_init(&parallel, count, count * 32)) {
+        printf("✗ Allocation failed\n");
+        free(names);
+        return 1;
+    }
+
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        snprintf(names[i], sizeof(names[i]), "%sRom %d %c%d", (rand() % 4) ? "" : "The ",
+                 rand() % 5000, 'a' + rand() % 26, i);
+        collation_set_add(&serial, names[i], strlen(names[i]), i);
+        collation_set_add(&parallel, names[i], strlen(names[i]), i);
+    }
+
+    mock_cpu_count = 1;
+    collation_set_sort(&serial);
+    mock_cpu_count = 4;
+    collation_set_sort(&parallel);
+
+    int same = 1, ordered = 1;
+    for (int i = 0; i < count; i++) {
+        if (serial.items[i].index != parallel.items[i].index) same = 0;
+        if (i > 0) {
+            const CollationItem* a = &parallel.items[i - 1];
+            const CollationItem* b = &parallel.items[i];
+            size_t n = a->length < b->length ? a->length : b->length;
+            int cmp = memcmp(a->key, b->key, n);
+            if (cmp > 0 || (cmp == 0 && a->length > b->length)) ordered = 0;
+        }
+    }
+
+    if (same && ordered) {
+        printf("✓ %d names sorted identically on 1 and 4 threads\n", count);
+    } else {
+        printf("✗ Parallel sort differs (same=%d, ordered=%d)\n", same, ordered);
+        failures++;
+    }
+
+    collation_set_free(&serial);
+    collation_set_free(&parallel);
+    free(names);
+    return failures;
+}
+
+// Run all collation tests
+int run_collation_tests() {
+    printf("=== Running Collation Tests ===\n");
+    int failures = 0;
+
+    failures += test_collation_order();
+    failures += test_collation_parallel_sort();
+
+    printf("=== Collation Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "../source/dir_cache.h"
+
+// Test function prototypes
+int test_dir_cache_hit_and_stale();
+int test_dir_cache_eviction();
+
+static char cache_root[256];
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_cache(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+// Creates a settled subdirectory and returns a one-file listing stamped for it
+static DirContent* make_listing(const char* name, char* path, size_t size) {
+    snprintf(path, size, "%s/%s", cache_root, name);
+    mkdir(path, 0755);
+    time_t settled = time(NULL) - 100;
+    struct utimbuf times = { settled, settled };
+    utime(path, &times);
+
+    DirContent* content = dir_content_create();
+    dir_content_add_file(content, "game.sfc", 8);
+    content->mtime = dir_cache_stamp(path);
+    return content;
+}
+
+// Test that a parked listing comes back until its directory changes
+int test_dir_cache_hit_and_stale() {
+    printf("\nTesting dir_cache_put and dir_cache_take:\n");
+    int failures = 0;
+    char path[512];
+
+    DirContent* content = make_listing("snes", path, sizeof(path));
+    failures += assert_cache("Settled directory is stamped", content->mtime != 0);
+    dir_cache_put(path, content);
+    failures += assert_cache("Cached listing returned", dir_cache_take(path) == content);
+    failures += assert_cache("Take removes the listing", dir_cache_take(path) == NULL);
+
+    dir_cache_put(path, content);
+    time_t changed = time(NULL) - 50;
+    struct utimbuf times = { changed, changed };
+    utime(path, &times);
+    failures += assert_cache("Changed directory misses", dir_cache_take(path) == NULL);
+    failures += assert_cache("Stale listing dropped", dir_cache_count() == 0);
+
+    DirContent* fresh = dir_content_create();
+    fresh->mtime = dir_cache_stamp(cache_root);
+    dir_cache_put(cache_root, fresh);
+    failures += assert_cache("Recently modified directory not cached", dir_cache_count() == 0);
+
+    return failures;
+}
+
+// Test that the least recently used listing is evicted first
+int test_dir_cache_eviction() {
+    printf("\nTesting dir_cache eviction:\n");
+    int failures = 0;
+    char path[512];
+    char first_path[512];
+    char second_path[512];
+
+    for (int i = 0; i < DIR_CACHE_MAX_LISTINGS; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "dir%d", i);
+        dir_cache_put(path, make_listing(name, path, sizeof(path)));
+        if (i == 0) strcpy(first_path, path);
+        if (i == 1) strcpy(second_path, path);
+    }
+    failures += assert_cache("Cache fills up", dir_cache_count() == DIR_CACHE_MAX_LISTINGS);
+
+    // Touch the oldest so the second oldest becomes the eviction candidate
+    dir_cache_put(first_path, dir_cache_take(first_path));
+    dir_cache_put(path, make_listing("extra", path, sizeof(path)));
+
+    failures += assert_cache("Count stays bounded", dir_cache_count() == DIR_CACHE_MAX_LISTINGS);
+    DirContent* second = dir_cache_take(second_path);
+    failures += assert_cache("Least recently used evicted", second == NULL);
+    DirContent* first = dir_cache_take(first_path);
+    failures += assert_cache("Recently used kept", first != NULL);
+    free_dir_content(first);
+
+    DirContent* huge = make_listing("huge", path, sizeof(path));
+    dir_content_reserve(huge, 0, DIR_CACHE_MAX_ENTRIES + 1);
+    huge->file_count = DIR_CACHE_MAX_ENTRIES + 1;
+    int before = dir_cache_count();
+    dir_cache_put(path, huge);
+    failures += assert_cache("Oversized listing not cached", dir_cache_count() == before);
+
+    dir_cache_clear();
+    failures += assert_cache("Clear empties the cache", dir_cache_count() == 0);
+    return failures;
+}
+
+// Run all dir_cache tests
+int run_dir_cache_tests() {
+    printf("=== Running DirCache Tests ===\n");
+    int failures = 0;
+
+    snprintf(cache_root, sizeof(cache_root), "/tmp/romlauncher-cache-XXXXXX");
+    if (!mkdtemp(cache_root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+
+    failures += test_dir_cache_hit_and_stale();
+    failures += test_dir_cache_eviction();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf '%s'", cache_root);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", cache_root);
+    }
+
+    printf("=== DirCache Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "../source/dir_content.h"
+#include "../source/emulator_selection.h"
+
+// Test function prototypes
+int test_dir_content_growth();
+int test_dir_content_trim();
+int test_dir_content_name_arena();
+int test_dir_content_entry_table();
+int test_dir_content_refill();
+int test_dir_content_revision();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_true(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+// Test that entries can be appended well past the old 1024 entry limit
+int test_dir_content_growth() {
+    printf("\nTesting dir_content_add_file:\n");
+    int failures = 0;
+
+    DirContent* content = dir_content_create();
+    failures += assert_true("Empty content has no storage",
+                            content && content->files.name_offset == NULL && content->file_capacity == 0);
+
+    int added = 0;
+    for (int i = 0; i < 3000; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "game %04d.sfc", i);
+        added += dir_content_add_file(content, name, strlen(name));
+    }
+
+    failures += assert_true("3000 files added", added == 3000 && content->file_count == 3000);
+    failures += assert_true("Capacity grew geometrically",
+                            content->file_capacity >= 3000 && content->file_capacity < 6000);
+    failures += assert_true("Entries kept in order",
+                            strcmp(dir_content_file_name(content, 2999), "game 2999.sfc") == 0);
+    failures += assert_true("New rows have no flags", content->files.flags[2999] == 0);
+
+    free_dir_content(content);
+    return failures;
+}
+
+// Test that trimming right-sizes the storage
+int test_dir_content_trim() {
+    printf("\nTesting dir_content_trim:\n");
+    int failures = 0;
+
+    DirContent* content = dir_content_create();
+    for (int i = 0; i < 12; i++) {
+        dir_content_add_file(content, "game.sfc", 8);
+    }
+    dir_content_add_dir(content, "subdir", 6);
+    dir_content_trim(content);
+
+    failures += assert_true("File capacity trimmed", content->file_capacity == 12);
+    failures += assert_true("Directory capacity trimmed", content->dir_capacity == 1);
+    failures += assert_true("Entries survive trim", strcmp(dir_content_dir_name(content, 0), "subdir") == 0);
+    failures += assert_true("Name arena trimmed", content->names_capacity == content->names_size);
+
+    free_dir_content(content);
+    return failures;
+}
+
+// Test that names are packed into one arena and copied only up to len
+int test_dir_content_name_arena() {
+    printf("\nTesting dir_content name arena:\n");
+    int failures = 0;
+
+    DirContent* content = dir_content_create();
+    dir_content_add_dir(content, "snes", 4);
+    dir_content_add_file(content, "mario.sfc trailing", 9);
+    dir_content_add_file(content, "zelda.sfc", 9);
+
+    failures += assert_true("Names are NUL-terminated at len",
+                            strcmp(dir_content_file_name(content, 0), "mario.sfc") == 0);
+    failures += assert_true("Names packed back to back",
+                            content->names_size == 5 + 10 + 10 &&
+                            content->files.name_offset[1] == 15);
+    failures += assert_true("Directory and file names share the arena",
+                            dir_content_dir_name(content, 0) == content->names);
+
+    free_dir_content(content);
+    return failures;
+}
+
+// Test the per-entry metadata derived when entries are added and sorted
+int test_dir_content_entry_table() {
+    printf("\nTesting dir_content entry table:\n");
+    int failures = 0;
+
+    DirContent* content = dir_content_create();
+    dir_content_add_dir(content, "v1.0", 4);
+    dir_content_add_file(content, "Zelda.sfc", 9);
+    dir_content_add_file(content, "Metroid.GBA", 11);
+    dir_content_add_file(content, "README", 6);
+    dir_content_set_favorite(content, 0, 1);
+
+    failures += assert_true("Directory flagged and unclassified",
+                            content->dirs.flags[0] == ENTRY_IS_DIR &&
+                            content->dirs.system[0] == SYSTEM_UNKNOWN);
+    failures += assert_true("Display length stops at the extension",
+                            content->files.display_length[0] == 5);
+    failures += assert_true("Extension offset points past the dot",
+                            strcmp(dir_content_file_extension(content, 1), "GBA") == 0);
+    failures += assert_true("System derived from extension",
+                            content->files.system[0] == SYSTEM_SNES &&
+                            content->files.system[1] == SYSTEM_GBA);
+    failures += assert_true("Name without extension is all display name",
+                            content->files.display_length[2] == 6 &&
+                            strcmp(dir_content_file_extension(content, 2), "") == 0 &&
+                            content->files.system[2] == SYSTEM_UNKNOWN);
+
+    failures += assert_true("Sort succeeds", dir_content_sort(content) == 1);
+    failures += assert_true("Names sorted",
+                            strcmp(dir_content_file_name(content, 0), "Metroid.GBA") == 0 &&
+                            strcmp(dir_content_file_name(content, 2), "Zelda.sfc") == 0);
+    failures += assert_true("Metadata moves with its name",
+                            content->files.system[2] == SYSTEM_SNES &&
+                            (content->files.flags[2] & ENTRY_FAVORITE) &&
+                            content->files.display_length[0] == 7);
+
+    uint32_t revision = dir_content_revision(content);
+    dir_content_set_favorite(content, 2, 0);
+    failures += assert_true("Clearing favorite changes the revision",
+                            !(content->files.flags[2] & ENTRY_FAVORITE) &&
+                            dir_content_revision(content) != revision);
+
+    free_dir_content(content);
+    return failures;
+}
+
+// Creates directory path holding count empty ROMs and one subdirectory
+static void make_rom_directory(const char* path, int count) {
+    char entry_path[512];
+    mkdir(path, 0755);
+    snprintf(entry_path, sizeof(entry_path), "%s/subdir", path);
+    mkdir(entry_path, 0755);
+    for (int i = 0; i < count; i++) {
+        snprintf(entry_path, sizeof(entry_path), "%s/game %d.sfc", path, i);
+        FILE* f = fopen(entry_path, "w");
+        if (f) fclose(f);
+    }
+}
+
+// Test that refilling reuses the buffers, so navigating does not grow memory
+int test_dir_content_refill() {
+    printf("\nTesting dir_content_refill:\n");
+    int failures = 0;
+
+    char root[256] = "/tmp/romlauncher-refill-XXXXXX";
+    if (!mkdtemp(root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+    char small[300];
+    char large[300];
+    snprintf(small, sizeof(small), "%s/small", root);
+    snprintf(large, sizeof(large), "%s/large", root);
+    make_rom_directory(small, 3);
+    make_rom_directory(large, 40);
+
+    DirContent* content = dir_content_create();
+    failures += assert_true("Refill lists a directory",
+                            dir_content_refill(content, large) == 1 &&
+                            content->dir_count == 1 && content->file_count == 40);
+    failures += assert_true("Refilled entries are sorted",
+                            strcmp(dir_content_file_name(content, 0), "game 0.sfc") == 0 &&
+                            strcmp(dir_content_file_name(content, 39), "game 39.sfc") == 0);
+
+    failures += assert_true("Refill replaces the entries",
+                            dir_content_refill(content, small) == 1 &&
+                            content->dir_count == 1 && content->file_count == 3);
+    size_t bytes = dir_content_bytes(content);
+    char* names = content->names;
+    int flat = 1;
+    for (int i = 0; i < 10000; i++) {
+        if (!dir_content_refill(content, i % 2 ? small : large) ||
+            dir_content_bytes(content) != bytes || content->names != names) {
+            flat = 0;
+            break;
+        }
+    }
+    failures += assert_true("Memory stays flat across 10k refills", flat);
+
+    char missing[300];
+    snprintf(missing, sizeof(missing), "%s/missing", root);
+    int file_count = content->file_count;
+    failures += assert_true("Missing directory leaves the listing alone",
+                            dir_content_refill(content, missing) == 0 &&
+                            content->file_count == file_count);
+
+    dir_content_clear(content);
+    failures += assert_true("Clear keeps the buffers",
+                            content->file_count == 0 && content->names_size == 0 &&
+                            dir_content_bytes(content) == bytes);
+    free_dir_content(content);
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf '%s'", root);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", root);
+    }
+    return failures;
+}
+
+// Test that the revision only changes when the listing would draw differently
+int test_dir_content_revision() {
+    printf("\nTesting dir_content revision:\n");
+    int failures = 0;
+    DirContent* content = dir_content_create();
+    DirContent* other = dir_content_create();
+
+    dir_content_add_file(content, "Zelda.sfc", 9);
+    uint32_t first = dir_content_revision(content);
+    failures += assert_true("Revision is stable while unchanged",
+                            first != 0 && dir_content_revision(content) == first);
+    failures += assert_true("Listings have different revisions",
+                            dir_content_revision(other) != first);
+
+    uint32_t previous = dir_content_revision(content);
+    dir_content_add_file(content, "Metroid.gba", 11);
+    failures += assert_true("Adding an entry changes the revision", dir_content_revision(content) != previous);
+
+    previous = dir_content_revision(content);
+    dir_content_sort(content);
+    failures += assert_true("Sorting changes the revision", dir_content_revision(content) != previous);
+
+    previous = dir_content_revision(content);
+    dir_content_set_favorite(content, 0, 1);
+    failures += assert_true("Favoriting changes the revision", dir_content_revision(content) != previous);
+
+    previous = dir_content_revision(content);
+    dir_content_touch(content);
+    failures += assert_true("Touching changes the revision", dir_content_revision(content) != previous);
+
+    previous = dir_content_revision(content);
+    dir_content_clear(content);
+    failures += assert_true("Clearing changes the revision", dir_content_revision(content) != previous);
+
+    free_dir_content(content);
+    free_dir_content(other);
+    return failures;
+}
+
+// Run all dir_content tests
+int run_dir_content_tests() {
+    printf("=== Running DirContent Tests ===\n");
+    int failures = 0;
+
+    failures += test_dir_content_growth();
+    failures += test_dir_content_trim();
+    failures += test_dir_content_name_arena();
+    failures += test_dir_content_entry_table();
+    failures += test_dir_content_refill();
+    failures += test_dir_content_revision();
+
+    printf("=== DirContent Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
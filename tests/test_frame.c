@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include "../source/frame.h"
+
+// Test function prototypes
+int test_frame_exchange();
+int test_frame_wait();
+int test_frame_wait_drawn();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_frame(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static void publish(int menu_selection) {
+    Frame* frame = frame_begin();
+    frame->menu_selection = menu_selection;
+    frame_publish();
+}
+
+// Test publishing frames and taking them for drawing
+int test_frame_exchange() {
+    printf("\nTesting frame exchange:\n");
+    int failures = 0;
+
+    failures += assert_frame("Init succeeds", frame_init() == 1);
+    failures += assert_frame("Nothing to take before a publish", frame_take() == NULL);
+
+    publish(1);
+    const Frame* drawing = frame_take();
+    failures += assert_frame("Published frame is taken", drawing && drawing->menu_selection == 1);
+    failures += assert_frame("A frame is taken once", frame_take() == NULL);
+
+    // Filling and publishing never touch the frame being drawn
+    failures += assert_frame("Frame being drawn is not handed out", frame_begin() != drawing);
+    publish(2);
+    failures += assert_frame("Frame being drawn is unchanged", drawing->menu_selection == 1);
+    failures += assert_frame("Frame being filled is not the published one", frame_begin() != drawing);
+
+    // Frames published faster than they are drawn are replaced
+    publish(3);
+    drawing = frame_take();
+    failures += assert_frame("Newest frame wins", drawing && drawing->menu_selection == 3);
+    failures += assert_frame("Older frames are dropped", frame_take() == NULL);
+
+    frame_shutdown();
+    return failures;
+}
+
+// Test sleeping until a frame arrives
+int test_frame_wait() {
+    printf("\nTesting frame wait:\n");
+    int failures = 0;
+
+    frame_init();
+    failures += assert_frame("Wait times out with nothing published", frame_wait(10) == 0);
+
+    publish(4);
+    failures += assert_frame("Wait reports a published frame", frame_wait(10) == 1);
+    frame_take();
+
+    frame_wake();
+    failures += assert_frame("Wake ends the wait without a frame", frame_wait(10) == 0);
+
+    frame_shutdown();
+    return failures;
+}
+
+// Test waiting for published frames to be drawn
+int test_frame_wait_drawn() {
+    printf("\nTesting frame wait drawn:\n");
+    int failures = 0;
+
+    frame_init();
+    failures += assert_frame("Nothing published is nothing to wait for", frame_wait_drawn(10) == 1);
+
+    publish(5);
+    failures += assert_frame("Untaken frame is not drawn", frame_wait_drawn(10) == 0);
+    frame_take();
+    failures += assert_frame("Taken frame is not drawn yet", frame_wait_drawn(10) == 0);
+
+    // A frame published while an older one is drawn still has to be drawn
+    publish(6);
+    frame_drawn();
+    failures += assert_frame("Drawing an older frame isn't enough", frame_wait_drawn(10) == 0);
+    frame_take();
+    frame_drawn();
+    failures += assert_frame("Newest frame drawn", frame_wait_drawn(10) == 1);
+
+    frame_shutdown();
+    return failures;
+}
+
+int run_frame_tests() {
+    int failures = 0;
+
+    failures += test_frame_exchange();
+    failures += test_frame_wait();
+    failures += test_frame_wait_drawn();
+
+    return failures;
+}
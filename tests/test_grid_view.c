@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../source/grid_view.h"
+#include "../source/dir_content.h"
+
+extern int mock_grid_loads;
+extern int mock_grid_load_result;
+extern int mock_grid_indices[];
+extern SDL_Event mock_events[];
+extern int mock_event_count;
+
+// Test function prototypes
+int test_grid_view_follow();
+int test_grid_view_loads();
+int test_grid_view_missing_art();
+int test_grid_view_tiles();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_grid(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+// A listing of dirs directories followed by files files
+static DirContent* make_listing(int dirs, int files) {
+    DirContent* content = dir_content_create();
+    char name[32];
+    for (int i = 0; i < dirs; i++) {
+        int len = snprintf(name, sizeof(name), "dir%04d", i);
+        dir_content_add_dir(content, name, (size_t)len);
+    }
+    for (int i = 0; i < files; i++) {
+        int len = snprintf(name, sizeof(name), "game%04d.nes", i);
+        dir_content_add_file(content, name, (size_t)len);
+    }
+    return content;
+}
+
+static GridTile* make_tile(uint32_t revision, int index) {
+    GridTile* tile = malloc(sizeof(GridTile));
+    tile->surface = calloc(1, sizeof(SDL_Surface));
+    tile->surface->w = GRID_TILE_W;
+    tile->surface->h = GRID_ART_H;
+    tile->revision = revision;
+    tile->index = index;
+    return tile;
+}
+
+// Test that the grid scrolls only to keep the selection on screen
+int test_grid_view_follow() {
+    printf("\nTesting grid_view scrolling:\n");
+    int failures = 0;
+
+    failures += assert_grid("Starts at the top", grid_view_follow(0, 100) == 0);
+    failures += assert_grid("Moving within the screen doesn't scroll",
+                            grid_view_follow(GRID_PAGE - 1, 100) == 0);
+    failures += assert_grid("Moving below the screen scrolls a row",
+                            grid_view_follow(GRID_PAGE, 100) == 1);
+    failures += assert_grid("Moving back up within the screen doesn't scroll",
+                            grid_view_follow(GRID_COLUMNS, 100) == 1);
+    failures += assert_grid("Moving above the screen scrolls up", grid_view_follow(0, 100) == 0);
+    failures += assert_grid("Jumping to the end shows the last full screen",
+                            grid_view_follow(99, 100) == 100 / GRID_COLUMNS - GRID_ROWS);
+    failures += assert_grid("Short listings stay at the top", grid_view_follow(3, 4) == 0);
+
+    SDL_Rect rect = grid_view_tile_rect(GRID_COLUMNS + 1, 0);
+    failures += assert_grid("Tiles are laid out in rows",
+                            rect.x == GRID_LEFT + GRID_PITCH_X && rect.y == GRID_TOP + GRID_PITCH_Y);
+    return failures;
+}
+
+// Test that only tiles on screen and one row ahead are loaded
+int test_grid_view_loads() {
+    printf("\nTesting grid_view loads:\n");
+    int failures = 0;
+    DirContent* content = make_listing(2, 200);
+    uint32_t revision = dir_content_revision(content);
+    int start, end;
+
+    grid_view_follow(0, 202);
+    grid_view_tiles(202, &start, &end);
+    failures += assert_grid("Resident tiles are the screen and a row below",
+                            start == 0 && end == GRID_PAGE + GRID_COLUMNS);
+
+    mock_grid_loads = 0;
+    grid_view_update(content, "/roms", 0);
+    failures += assert_grid("Loads are capped", mock_grid_loads == GRID_MAX_LOADS);
+    failures += assert_grid("Resident tiles are wanted", grid_view_wanted(revision, GRID_PAGE));
+    failures += assert_grid("Tiles past the look-ahead row are not",
+                            !grid_view_wanted(revision, GRID_PAGE + GRID_COLUMNS));
+    grid_view_update(content, "/roms", 0);
+    failures += assert_grid("No loads start while the cap is reached", mock_grid_loads == GRID_MAX_LOADS);
+
+    // Finished loads make room for the rest, each file tile asked for once;
+    // the last round leaves one load running
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < GRID_MAX_LOADS; i++) grid_view_load_done();
+        grid_view_update(content, "/roms", 0);
+    }
+    failures += assert_grid("Every resident file tile is loaded once",
+                            mock_grid_loads == GRID_PAGE + GRID_COLUMNS - 2);
+
+    grid_view_load_done();
+    mock_grid_loads = 0;
+    grid_view_update(content, "/roms", GRID_PAGE + GRID_COLUMNS);
+    failures += assert_grid("Scrolling down loads the new rows", mock_grid_loads == GRID_MAX_LOADS);
+    failures += assert_grid("Tiles scrolled away are no longer wanted", !grid_view_wanted(revision, 0));
+    failures += assert_grid("Tiles of another revision are not wanted",
+                            !grid_view_wanted(revision + 1, GRID_PAGE + GRID_COLUMNS));
+
+    // Tiles that arrive after scrolling away are dropped
+    GridTile* stale = make_tile(revision, 0);
+    failures += assert_grid("Stale tile is refused", !grid_view_accept(stale));
+    grid_view_free_tile(stale);
+    GridTile* fresh = make_tile(revision, GRID_PAGE + GRID_COLUMNS);
+    failures += assert_grid("Wanted tile is accepted", grid_view_accept(fresh));
+    grid_view_free_tile(fresh);
+
+    // A loader that fails to start doesn't hold a place under the cap
+    for (int i = 0; i < GRID_MAX_LOADS; i++) grid_view_load_done();
+    dir_content_touch(content);
+    mock_grid_loads = 0;
+    mock_grid_load_result = 0;
+    grid_view_update(content, "/roms", GRID_PAGE + GRID_COLUMNS);
+    failures += assert_grid("Failed loads are not retried or counted",
+                            mock_grid_loads == GRID_PAGE + GRID_COLUMNS);
+    mock_grid_load_result = 1;
+
+    grid_view_follow(0, 0);
+    free_dir_content(content);
+    return failures;
+}
+
+// Test that loads finding no art still let the rest of the page load, with
+// no input in between
+int test_grid_view_missing_art() {
+    printf("\nTesting grid_view loads without art:\n");
+    int failures = 0;
+    DirContent* content = make_listing(0, 40);
+    uint32_t revision = dir_content_revision(content);
+
+    mock_grid_loads = 0;
+    mock_event_count = 0;
+    grid_view_update(content, "/roms", 0);
+
+    int finished = 0;
+    int accepted = 0;
+    int empty = 0;
+    while (finished < mock_grid_loads) {
+        // The loaders finish as browser.c's do: the load is done before its
+        // event is sent, and only every fifth tile has art
+        for (int started = mock_grid_loads; finished < started; finished++) {
+            int index = mock_grid_indices[finished];
+            SDL_Event event;
+            SDL_zero(event);
+            event.type = SDL_USEREVENT;
+            event.user.code = GRID_EVENT_CODE;
+            event.user.data1 = index % 5 == 0 ? make_tile(revision, index) : NULL;
+            grid_view_load_done();
+            SDL_PushEvent(&event);
+        }
+
+        // The main loop takes each event and then updates the grid
+        for (int i = 0; i < mock_event_count; i++) {
+            GridTile* tile = mock_events[i].user.data1;
+            if (grid_view_accept(tile)) accepted++;
+            else if (!tile) empty++;
+            grid_view_free_tile(tile);
+        }
+        mock_event_count = 0;
+        grid_view_update(content, "/roms", 0);
+    }
+
+    failures += assert_grid("Every resident tile is requested",
+                            mock_grid_loads == GRID_PAGE + GRID_COLUMNS);
+    failures += assert_grid("Tiles with art are accepted", accepted == 3);
+    failures += assert_grid("Loads without art are reported", empty == GRID_PAGE + GRID_COLUMNS - 3);
+
+    grid_view_follow(0, 0);
+    free_dir_content(content);
+    return failures;
+}
+
+// Test that uploaded tiles are found by key and replace their slot
+int test_grid_view_tiles() {
+    printf("\nTesting grid_view tile textures:\n");
+    int failures = 0;
+    SDL_Rect size;
+
+    grid_view_upload(NULL, make_tile(7, 3));
+    failures += assert_grid("Uploaded tile is found", grid_view_texture(7, 3, &size) != NULL);
+    failures += assert_grid("Texture size is the tile's", size.w == GRID_TILE_W && size.h == GRID_ART_H);
+    failures += assert_grid("Other revisions don't match", grid_view_texture(8, 3, &size) == NULL);
+
+    grid_view_upload(NULL, make_tile(7, 3 + GRID_SLOTS));
+    failures += assert_grid("A tile sharing the slot replaces it",
+                            grid_view_texture(7, 3, &size) == NULL &&
+                            grid_view_texture(7, 3 + GRID_SLOTS, &size) != NULL);
+
+    grid_view_clear();
+    failures += assert_grid("Clear drops every tile", grid_view_texture(7, 3 + GRID_SLOTS, &size) == NULL);
+    return failures;
+}
+
+int run_grid_view_tests() {
+    int failures = 0;
+
+    failures += test_grid_view_follow();
+    failures += test_grid_view_loads();
+    failures += test_grid_view_missing_art();
+    failures += test_grid_view_tiles();
+
+    return failures;
+}
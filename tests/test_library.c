@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "../source/library.h"
+
+// Test function prototypes
+int test_library_build_and_lookup();
+int test_library_incremental_refresh();
+int test_library_corrupt_index();
+
+static char test_root[256];
+static char test_index[300];
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_int_equals(const char* test_name, int expected, int actual) {
+    if (expected == actual) {
+        printf("✓ %s: %d\n", test_name, actual);
+        return 0;
+    } else {
+        printf("✗ %s: Expected %d but got %d\n", test_name, expected, actual);
+        return 1;
+    }
+}
+
+static void make_path(char* buffer, size_t size, const char* relative) {
+    snprintf(buffer, size, "%s/%s", test_root, relative);
+}
+
+static void touch_file(const char* relative) {
+    char path[512];
+    make_path(path, sizeof(path), relative);
+    FILE* fp = fopen(path, "w");
+    if (fp) fclose(fp);
+}
+
+static void make_dir(const char* relative) {
+    char path[512];
+    make_path(path, sizeof(path), relative);
+    mkdir(path, 0755);
+}
+
+// Backdates a directory's mtime so the index treats it as settled
+static void set_dir_mtime(const char* relative, time_t mtime) {
+    char path[512];
+    make_path(path, sizeof(path), relative);
+    struct utimbuf times = { mtime, mtime };
+    utime(path, &times);
+}
+
+static int count_files(const char* relative) {
+    char path[512];
+    make_path(path, sizeof(path), relative);
+    LibrarySlice slice;
+    if (!library_lookup(path, &slice)) return -1;
+    return slice.file_count;
+}
+
+// Test building an index and looking directories up in it
+int test_library_build_and_lookup() {
+    printf("\nTesting library_open and library_lookup:\n");
+    int failures = 0;
+    time_t settled = time(NULL) - 100;
+
+    make_dir("snes");
+    make_dir("nes");
+    touch_file("snes/b.sfc");
+    touch_file("snes/a.sfc");
+    touch_file("nes/c.nes");
+    touch_file("readme.txt");
+    set_dir_mtime("snes", settled);
+    set_dir_mtime("nes", settled);
+    set_dir_mtime("", settled);
+
+    failures += assert_int_equals("Index opens", 1, library_open(test_root, test_index));
+
+    LibrarySlice slice;
+    failures += assert_int_equals("Root is indexed", 1, library_lookup(test_root, &slice));
+    failures += assert_int_equals("Root directory count", 2, slice.dir_count);
+    failures += assert_int_equals("Root file count", 1, slice.file_count);
+    failures += assert_int_equals("Directories sorted first",
+                                  0, strcmp(library_entry_name(&slice, 0), "nes"));
+    failures += assert_int_equals("Files sorted",
+                                  0, strcmp(library_entry_name(&slice, 2), "readme.txt"));
+
+    failures += assert_int_equals("Subdirectory file count", 2, count_files("snes"));
+    failures += assert_int_equals("Unknown directory misses", -1, count_files("gba"));
+
+    return failures;
+}
+
+// Test that a refresh only rereads directories whose mtime moved
+int test_library_incremental_refresh() {
+    printf("\nTesting library_refresh:\n");
+    int failures = 0;
+    time_t settled = time(NULL) - 100;
+
+    // New ROM in a directory whose mtime changed: picked up
+    touch_file("snes/d.sfc");
+    set_dir_mtime("snes", settled + 50);
+
+    // New ROM in a directory whose mtime was restored: not reread
+    touch_file("nes/e.nes");
+    set_dir_mtime("nes", settled);
+
+    failures += assert_int_equals("Refresh succeeds", 1, library_refresh(test_root, test_index));
+    failures += assert_int_equals("Changed directory reread", 3, count_files("snes"));
+    failures += assert_int_equals("Unchanged directory reused", 1, count_files("nes"));
+
+    // Reopening the rewritten index keeps the patched listing
+    library_close();
+    failures += assert_int_equals("Index reopens", 1, library_open(test_root, test_index));
+    failures += assert_int_equals("Patched listing persisted", 3, count_files("snes"));
+
+    return failures;
+}
+
+// Reads (write 0) or overwrites (write 1) the last entry of the index file,
+// filling in header
+static int index_last_entry(LibraryHeader *header, LibraryEntry *entry, int write) {
+    FILE *file = fopen(test_index, "r+b");
+    if (!file || fread(header, sizeof(*header), 1, file) != 1 || header->entry_count == 0) {
+        if (file) fclose(file);
+        return 0;
+    }
+
+    long offset = (long)(sizeof(LibraryHeader) + header->dir_count * sizeof(LibraryDir) +
+                         (header->entry_count - 1) * sizeof(LibraryEntry));
+    int done = fseek(file, offset, SEEK_SET) == 0 &&
+               (write ? fwrite(entry, sizeof(*entry), 1, file) : fread(entry, sizeof(*entry), 1, file)) == 1;
+    fclose(file);
+    return done;
+}
+
+// Points the last entry's name at offset bytes from the end of the string
+// table, name_length bytes long, and checks library_open() rebuilds the
+// index rather than using it
+static int open_corrupt_index(const char *test_name, int offset, uint16_t name_length) {
+    int failures = 0;
+    LibraryHeader header;
+    LibraryEntry corrupt;
+    library_close();
+    if (!index_last_entry(&header, &corrupt, 0)) return assert_int_equals("Index readable", 1, 0);
+
+    uint32_t name_offset = (uint32_t)((int64_t)header.strings_size + offset);
+    corrupt.name_offset = name_offset;
+    corrupt.name_length = name_length;
+    failures += assert_int_equals(test_name, 1, index_last_entry(&header, &corrupt, 1));
+    failures += assert_int_equals("Corrupt index is rebuilt", 1, library_open(test_root, test_index));
+
+    LibraryEntry entry;
+    failures += assert_int_equals("Corrupt entry replaced", 1,
+                                  index_last_entry(&header, &entry, 0) &&
+                                  (entry.name_offset != name_offset || entry.name_length != name_length));
+    failures += assert_int_equals("Rebuilt listing is complete", 3, count_files("snes"));
+    return failures;
+}
+
+// Test that an index with an out-of-range name is rebuilt on open
+int test_library_corrupt_index() {
+    printf("\nTesting library_open with a corrupt index:\n");
+    int failures = 0;
+
+    failures += open_corrupt_index("Name starts past the strings", 100, 1);
+    failures += open_corrupt_index("Name runs off the strings", -2, 100);
+    failures += open_corrupt_index("Name's NUL is past the strings", -2, 2);
+
+    return failures;
+}
+
+// Run all library tests
+int run_library_tests() {
+    printf("=== Running Library Tests ===\n");
+    int failures = 0;
+
+    snprintf(test_root, sizeof(test_root), "/tmp/romlauncher-test-XXXXXX");
+    if (!mkdtemp(test_root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+    snprintf(test_index, sizeof(test_index), "%s.idx", test_root);
+
+    failures += test_library_build_and_lookup();
+    failures += test_library_incremental_refresh();
+    failures += test_library_corrupt_index();
+
+    library_close();
+    char command[600];
+    snprintf(command, sizeof(command), "rm -rf '%s' '%s'", test_root, test_index);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", test_root);
+    }
+
+    printf("=== Library Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include "../source/list_view.h"
+
+extern Uint32 mock_ticks;
+extern SDL_bool mock_render_targets;
+extern int mock_geometry_calls;
+extern int mock_geometry_vertices;
+extern Uint64 mock_perf_counter;
+
+// Test function prototypes
+int test_list_view_scrolling();
+int test_list_view_slots();
+int test_list_view_prerender();
+int test_list_view_budget();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_list(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static int rows_drawn = 0;
+static int first_row_drawn = -1;
+static Uint64 row_cost = 0;     // Performance counter ticks (us) each row takes
+
+static void count_row(void* data __attribute__((unused)), int index,
+                      int y __attribute__((unused))) {
+    if (rows_drawn == 0) first_row_drawn = index;
+    rows_drawn++;
+    mock_perf_counter += row_cost;
+}
+
+// Draws a 100-row list with row selected highlighted and returns how many
+// rows had to be drawn into slots
+static int draw_selected(uint32_t revision, int selected) {
+    rows_drawn = 0;
+    first_row_drawn = -1;
+    list_view_draw(NULL, NULL, 30, revision, 100, selected, -1, count_row, NULL);
+    return rows_drawn;
+}
+
+static int draw_rows(uint32_t revision) {
+    return draw_selected(revision, 0);
+}
+
+// Test the viewport position, visible range and scroll easing
+int test_list_view_scrolling() {
+    printf("\nTesting list_view scrolling:\n");
+    int failures = 0;
+    int start, end;
+
+    list_view_scroll_to(30, 0);
+    list_view_visible(100, &start, &end);
+    failures += assert_list("Jump shows the row at the top",
+                            !list_view_scrolling() && list_view_row_y(30) == LIST_VIEW_TOP);
+    failures += assert_list("One page of rows is visible", start == 30 && end == 30 + LIST_VIEW_ROWS);
+    list_view_visible(35, &start, &end);
+    failures += assert_list("Visible rows stop at the end of the list", start == 30 && end == 35);
+
+    list_view_scroll_to(45, 1);
+    list_view_update(mock_ticks + 20);
+    int y = list_view_row_y(45);
+    list_view_visible(100, &start, &end);
+    failures += assert_list("Animated scroll moves part of the way",
+                            list_view_scrolling() && y > LIST_VIEW_TOP && y < LIST_VIEW_TOP + LIST_VIEW_HEIGHT);
+    failures += assert_list("Mid-scroll shows a partial extra row", end - start == LIST_VIEW_ROWS + 1);
+
+    for (int i = 2; i < 100 && list_view_update(mock_ticks + i * 20); i++) {}
+    failures += assert_list("Scroll settles on its target",
+                            !list_view_scrolling() && list_view_row_y(45) == LIST_VIEW_TOP);
+
+    list_view_scroll_to(0, 0);
+    list_view_scroll_to(300, 1);
+    failures += assert_list("Long scroll only animates the last page",
+                            list_view_row_y(300) == LIST_VIEW_TOP + LIST_VIEW_HEIGHT);
+    list_view_scroll_to(0, 0);
+    return failures;
+}
+
+// Test that rows are drawn into slots only when they scroll in or change
+int test_list_view_slots() {
+    printf("\nTesting list_view slots:\n");
+    int failures = 0;
+
+    list_view_scroll_to(0, 0);
+    failures += assert_list("First draw fills a page of slots", draw_rows(5) == LIST_VIEW_ROWS);
+    failures += assert_list("Redraw reuses every slot", draw_rows(5) == 0);
+    mock_geometry_calls = 0;
+    draw_rows(5);
+    failures += assert_list("Visible rows are copied in one call",
+                            mock_geometry_calls == 1 && mock_geometry_vertices == LIST_VIEW_ROWS * 4);
+    list_view_draw(NULL, NULL, 30, 5, 100, 2, 2, count_row, NULL);
+    failures += assert_list("Hidden row is left off the screen",
+                            mock_geometry_vertices == (LIST_VIEW_ROWS - 1) * 4 && !list_view_pending());
+
+    list_view_scroll_to(1, 0);
+    failures += assert_list("Scrolling a row draws only the new row", draw_rows(5) == 1);
+    list_view_scroll_to(0, 0);
+    failures += assert_list("Scrolling back reuses the spare slot", draw_rows(5) == 0);
+
+    list_view_scroll_to(2 * LIST_VIEW_ROWS, 0);
+    failures += assert_list("Recycled slots are redrawn", draw_rows(5) == LIST_VIEW_ROWS);
+    failures += assert_list("New revision redraws the rows", draw_rows(6) == LIST_VIEW_ROWS);
+
+    list_view_clear();
+    mock_render_targets = SDL_FALSE;
+    failures += assert_list("No slots without render targets",
+                            list_view_draw(NULL, NULL, 30, 6, 100, 0, -1, count_row, NULL) == 0);
+    mock_render_targets = SDL_TRUE;
+
+    list_view_scroll_to(0, 0);
+    list_view_clear();
+    return failures;
+}
+
+// Test that neighbouring pages are drawn ahead a row at a time
+int test_list_view_prerender() {
+    printf("\nTesting list_view prerender:\n");
+    int failures = 0;
+    int next = LIST_VIEW_ROWS;
+
+    list_view_scroll_to(0, 0);
+    draw_rows(7);
+    rows_drawn = 0;
+    failures += assert_list("Prerender draws one row per call",
+                            list_view_prerender(NULL, NULL, 30, 7, next, next + LIST_VIEW_ROWS,
+                                                count_row, NULL) == 1 && rows_drawn == 1);
+    while (list_view_prerender(NULL, NULL, 30, 7, next, next + LIST_VIEW_ROWS, count_row, NULL)) {}
+    failures += assert_list("Prerender covers the whole page", rows_drawn == LIST_VIEW_ROWS);
+    failures += assert_list("Prerender stops once the page is ready",
+                            list_view_prerender(NULL, NULL, 30, 7, next, next + LIST_VIEW_ROWS,
+                                                count_row, NULL) == 0);
+
+    list_view_scroll_to(next, 0);
+    failures += assert_list("Turning to a prerendered page draws nothing", draw_rows(7) == 0);
+    failures += assert_list("Page turned from is still cached",
+                            list_view_prerender(NULL, NULL, 30, 7, 0, next, count_row, NULL) == 0);
+
+    list_view_scroll_to(0, 0);
+    list_view_clear();
+    return failures;
+}
+
+// Test that filling slots is spread across frames within the budget
+int test_list_view_budget() {
+    printf("\nTesting list_view budget:\n");
+    int failures = 0;
+
+    list_view_scroll_to(0, 0);
+    list_view_set_budget(3);
+    row_cost = 1000;
+    failures += assert_list("A frame stops once its budget is spent", draw_selected(8, 7) == 3);
+    failures += assert_list("The selected row is drawn first", first_row_drawn == 7);
+    failures += assert_list("Rows left over are pending", list_view_pending() == LIST_VIEW_ROWS - 3);
+
+    draw_selected(8, 7);
+    failures += assert_list("Nearest rows come next", first_row_drawn == 9);
+    while (list_view_pending()) draw_selected(8, 7);
+    failures += assert_list("Later frames finish the page", draw_selected(8, 7) == 0);
+
+    list_view_set_budget(0);
+    failures += assert_list("Every frame draws at least one row", draw_selected(9, 0) == 1);
+    failures += assert_list("Selection at the edge works outward", draw_selected(9, 0) == 1 &&
+                            first_row_drawn == 1);
+
+    row_cost = 0;
+    list_view_set_budget(LIST_ROW_BUDGET_MS);
+    failures += assert_list("A fast page is drawn in one frame",
+                            draw_selected(10, 0) == LIST_VIEW_ROWS && !list_view_pending());
+    list_view_clear();
+    return failures;
+}
+
+int run_list_view_tests() {
+    int failures = 0;
+
+    failures += test_list_view_scrolling();
+    failures += test_list_view_slots();
+    failures += test_list_view_prerender();
+    failures += test_list_view_budget();
+
+    return failures;
+}
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "../source/navigation.h"
+#include "../source/dir_cache.h"
+#include "../source/library.h"
+#include "../source/config.h"
+
+// Test function prototypes
+int test_navigation_walk();
+
+#define WALK_SYSTEMS 12     // More than DIR_CACHE_MAX_LISTINGS, so the cache evicts
+#define WALK_SETS 2
+#define WALK_STEPS 10000
+
+static char walk_root[256];
+static char walk_index[300];
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_navigation(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static void make_walk_dir(const char* path, int files) {
+    char file_path[600];
+    mkdir(path, 0755);
+    for (int i = 0; i < files; i++) {
+        snprintf(file_path, sizeof(file_path), "%s/game%03d.sfc", path, i);
+        FILE* file = fopen(file_path, "w");
+        if (file) fclose(file);
+    }
+}
+
+// Settles a directory's mtime so its listings can be cached
+static void settle_dir(const char* path) {
+    time_t settled = time(NULL) - 100;
+    struct utimbuf times = { settled, settled };
+    utime(path, &times);
+}
+
+// root holds WALK_SYSTEMS systems of 40 files, each with WALK_SETS sets of
+// 10 + i files, so every level has a listing of its own size
+static void make_walk_tree(void) {
+    char path[512];
+    make_walk_dir(walk_root, 3);
+    for (int s = 0; s < WALK_SYSTEMS; s++) {
+        snprintf(path, sizeof(path), "%s/system%02d", walk_root, s);
+        make_walk_dir(path, 40);
+        for (int i = 0; i < WALK_SETS; i++) {
+            snprintf(path, sizeof(path), "%s/system%02d/set%d", walk_root, s, i);
+            make_walk_dir(path, 10 + i);
+            settle_dir(path);
+        }
+        snprintf(path, sizeof(path), "%s/system%02d", walk_root, s);
+        settle_dir(path);
+    }
+    settle_dir(walk_root);
+}
+
+// Files a listing of current_path should hold
+static int expected_files(const char* current_path) {
+    const char* set = strstr(current_path, "/set");
+    if (set) return 10 + atoi(set + 4);
+    return strstr(current_path, "/system") ? 40 : 3;
+}
+
+// Test that wandering the tree through the browser's navigation keeps the
+// cache and the listing's buffers bounded
+int test_navigation_walk() {
+    printf("\nTesting change_directory and go_up_directory:\n");
+    int failures = 0;
+
+    failures += assert_navigation("Index opens", library_open(walk_root, walk_index) == 1);
+
+    char current_path[MAX_PATH_LEN];
+    snprintf(current_path, sizeof(current_path), "%s", walk_root);
+    DirContent* content = list_files(current_path);
+    if (!content) return failures + assert_navigation("Root listed", 0);
+
+    int depth = 0;
+    int listings_match = 1;
+    int cache_bounded = 1;
+    size_t warm_peak = 0;
+    size_t peak = 0;
+    unsigned int seed = 12345;
+
+    for (int step = 0; step < WALK_STEPS; step++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int choice = seed >> 16;
+
+        if (depth == 2 || (depth > 0 && choice % 3 == 0)) {
+            go_up_directory(content, current_path, walk_root);
+            depth--;
+        } else {
+            change_directory(content, (int)(choice % (unsigned int)content->dir_count), current_path);
+            depth++;
+        }
+
+        if (content->file_count != expected_files(current_path)) listings_match = 0;
+        if (dir_cache_count() > DIR_CACHE_MAX_LISTINGS || dir_cache_bytes() > DIR_CACHE_MAX_BYTES) {
+            cache_bounded = 0;
+        }
+
+        // Memory of the listing shown plus the ones parked, after the first
+        // half against the peak of the first half
+        size_t bytes = dir_content_bytes(content) + dir_cache_bytes();
+        if (step < WALK_STEPS / 2) {
+            if (bytes > warm_peak) warm_peak = bytes;
+        } else if (bytes > peak) {
+            peak = bytes;
+        }
+    }
+
+    failures += assert_navigation("Every step shows the listing of its directory", listings_match);
+    failures += assert_navigation("Cached listings stay within the cache's limits", cache_bounded);
+    failures += assert_navigation("Cache filled up along the way", dir_cache_count() > 0);
+    failures += assert_navigation("Memory stays flat across 10k navigations", peak <= warm_peak);
+
+    free_dir_content(content);
+    dir_cache_clear();
+    library_close();
+    return failures;
+}
+
+int run_navigation_tests() {
+    printf("=== Running Navigation Tests ===\n");
+    int failures = 0;
+
+    snprintf(walk_root, sizeof(walk_root), "/tmp/romlauncher-walk-XXXXXX");
+    if (!mkdtemp(walk_root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+    snprintf(walk_index, sizeof(walk_index), "%s.idx", walk_root);
+    make_walk_tree();
+
+    failures += test_navigation_walk();
+
+    char command[600];
+    snprintf(command, sizeof(command), "rm -rf '%s' '%s'", walk_root, walk_index);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", walk_root);
+    }
+
+    printf("=== Navigation Tests Complete ===\n\n");
+    return failures;
+}
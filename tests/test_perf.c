@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include "../source/perf.h"
+
+extern Uint32 mock_ticks;
+extern Uint64 mock_perf_counter;
+
+// Test function prototypes
+int test_perf_counters();
+int test_perf_frame_phases();
+int test_perf_frame_history();
+int test_perf_raster_rate();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_perf(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static int near(float value, float expected) {
+    return value > expected - 0.01f && value < expected + 0.01f;
+}
+
+// Records one frame split into input, logic and render time in ms
+static void record_frame(int input_ms, int logic_ms, int render_ms) {
+    perf_frame_begin();
+    mock_perf_counter += input_ms * 1000;
+    perf_mark(PERF_PHASE_INPUT);
+    mock_perf_counter += logic_ms * 1000;
+    perf_mark(PERF_PHASE_LOGIC);
+    perf_frame_submit();
+    perf_render_begin();
+    mock_perf_counter += render_ms * 1000;
+    perf_frame_end();
+}
+
+int test_perf_counters() {
+    printf("\nTesting perf counters:\n");
+    int failures = 0;
+
+    int before = perf_counter(PERF_BOXART_JOBS);
+    perf_count(PERF_BOXART_JOBS, 2);
+    perf_count(PERF_BOXART_JOBS, -1);
+    failures += assert_perf("Counter adds deltas", perf_counter(PERF_BOXART_JOBS) == before + 1);
+    perf_count(PERF_BOXART_JOBS, -1);
+
+    return failures;
+}
+
+int test_perf_frame_phases() {
+    printf("\nTesting perf frame phases:\n");
+    int failures = 0;
+
+    record_frame(2, 3, 5);
+    failures += assert_perf("Input time is charged", near(perf_phase_ms(PERF_PHASE_INPUT), 2));
+    failures += assert_perf("Logic time is charged", near(perf_phase_ms(PERF_PHASE_LOGIC), 3));
+    failures += assert_perf("Render time is charged", near(perf_phase_ms(PERF_PHASE_RENDER), 5));
+
+    float times[PERF_HISTORY];
+    int count = perf_frame_times(times);
+    failures += assert_perf("Frame time is the render thread's", count > 0 && near(times[count - 1], 5));
+
+    // Phases not marked in an iteration read as zero once it is submitted
+    perf_frame_begin();
+    mock_perf_counter += 4000;
+    perf_frame_submit();
+    failures += assert_perf("Phases reset each frame", near(perf_phase_ms(PERF_PHASE_INPUT), 0) &&
+                                                       near(perf_phase_ms(PERF_PHASE_LOGIC), 0));
+
+    // Main thread time spent while a frame is drawn is not render time
+    perf_render_begin();
+    mock_perf_counter += 1000;
+    perf_frame_begin();
+    mock_perf_counter += 2000;
+    perf_mark(PERF_PHASE_INPUT);
+    perf_frame_end();
+    failures += assert_perf("Render time runs from perf_render_begin",
+                            near(perf_phase_ms(PERF_PHASE_RENDER), 3) &&
+                            near(perf_phase_ms(PERF_PHASE_INPUT), 0));
+
+    return failures;
+}
+
+int test_perf_frame_history() {
+    printf("\nTesting perf frame history:\n");
+    int failures = 0;
+
+    for (int i = 0; i < PERF_HISTORY + 5; i++) {
+        record_frame(0, 0, i + 1);
+    }
+
+    float times[PERF_HISTORY];
+    int count = perf_frame_times(times);
+    failures += assert_perf("History is capped", count == PERF_HISTORY);
+    failures += assert_perf("Oldest frames are dropped first", near(times[0], 6));
+    failures += assert_perf("Newest frame is last", near(times[PERF_HISTORY - 1], PERF_HISTORY + 5));
+
+    return failures;
+}
+
+int test_perf_raster_rate() {
+    printf("\nTesting perf raster rate:\n");
+    int failures = 0;
+
+    // Start a fresh one-second window
+    mock_ticks += 1000;
+    record_frame(0, 0, 1);
+    int previous = perf_rasters_per_second();
+
+    perf_count(PERF_TEXT_RASTERS, 7);
+    mock_ticks += 500;
+    record_frame(0, 0, 1);
+    failures += assert_perf("Rate holds within the second", perf_rasters_per_second() == previous);
+
+    mock_ticks += 600;
+    record_frame(0, 0, 1);
+    failures += assert_perf("Rate rolls over after a second", perf_rasters_per_second() == 7);
+    failures += assert_perf("Raster counter restarts", perf_counter(PERF_TEXT_RASTERS) == 0);
+
+    return failures;
+}
+
+int run_perf_tests() {
+    int failures = 0;
+
+    failures += test_perf_counters();
+    failures += test_perf_frame_phases();
+    failures += test_perf_frame_history();
+    failures += test_perf_raster_rate();
+
+    return failures;
+}
@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <SDL.h>
+#include "../source/prefetch.h"
+#include "../source/dir_cache.h"
+
+extern SDL_Event mock_events[];
+extern int mock_event_count;
+extern Uint32 mock_ticks;
+
+// Test function prototypes
+int test_prefetch_after_dwell();
+int test_prefetch_target_change();
+
+static char prefetch_root[256];
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_prefetch(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+// Creates a settled subdirectory holding a few ROMs
+static void make_directory(const char* name, char* path, size_t size) {
+    snprintf(path, size, "%s/%s", prefetch_root, name);
+    mkdir(path, 0755);
+    const char* files[] = { "zelda.sfc", "mario.sfc", "metroid.sfc" };
+    for (int i = 0; i < 3; i++) {
+        char file_path[600];
+        snprintf(file_path, sizeof(file_path), "%s/%s", path, files[i]);
+        FILE* f = fopen(file_path, "w");
+        if (f) fclose(f);
+    }
+    time_t settled = time(NULL) - 100;
+    struct utimbuf times = { settled, settled };
+    utime(path, &times);
+}
+
+// Hands every queued result to prefetch_accept and returns how many there were
+static int deliver_results(void) {
+    int delivered = 0;
+    for (int i = 0; i < mock_event_count; i++) {
+        if (mock_events[i].user.code != PREFETCH_EVENT_CODE) continue;
+        prefetch_accept((PrefetchResult*)mock_events[i].user.data1);
+        delivered++;
+    }
+    mock_event_count = 0;
+    return delivered;
+}
+
+// Test that a directory is only read once the selection has rested on it
+int test_prefetch_after_dwell() {
+    printf("\nTesting prefetch dwell:\n");
+    int failures = 0;
+    char path[512];
+    make_directory("snes", path, sizeof(path));
+
+    mock_ticks = 1000;
+    mock_event_count = 0;
+    prefetch_request(path);
+    failures += assert_prefetch("Wait covers the whole dwell", prefetch_wait() == PREFETCH_DWELL_MS);
+    mock_ticks += PREFETCH_DWELL_MS - 1;
+    prefetch_update();
+    failures += assert_prefetch("Nothing read before the dwell", mock_event_count == 0);
+    failures += assert_prefetch("Wait counts down", prefetch_wait() == 1);
+
+    mock_ticks += 1;
+    prefetch_update();
+    failures += assert_prefetch("Listing delivered after the dwell", deliver_results() == 1);
+    failures += assert_prefetch("Nothing left to wait for", prefetch_wait() == UINT32_MAX);
+    failures += assert_prefetch("Listing parked in the cache", dir_cache_contains(path));
+
+    DirContent* content = dir_cache_take(path);
+    failures += assert_prefetch("Prefetched listing is sorted",
+        content && content->file_count == 3 &&
+        strcmp(dir_content_file_name(content, 0), "mario.sfc") == 0 &&
+        strcmp(dir_content_file_name(content, 2), "zelda.sfc") == 0);
+    dir_cache_put(path, content);
+
+    // Resting on it again must not read it twice
+    prefetch_request(NULL);
+    prefetch_request(path);
+    mock_ticks += PREFETCH_DWELL_MS;
+    prefetch_update();
+    failures += assert_prefetch("Cached directory not read again", mock_event_count == 0);
+
+    prefetch_shutdown();
+    dir_cache_clear();
+    return failures;
+}
+
+// Test that moving the selection restarts the dwell and drops the old target
+int test_prefetch_target_change() {
+    printf("\nTesting prefetch target change:\n");
+    int failures = 0;
+    char first[512];
+    char second[512];
+    make_directory("nes", first, sizeof(first));
+    make_directory("gba", second, sizeof(second));
+
+    mock_ticks = 5000;
+    mock_event_count = 0;
+    prefetch_request(first);
+    mock_ticks += PREFETCH_DWELL_MS / 2;
+    prefetch_request(second);
+    mock_ticks += PREFETCH_DWELL_MS / 2;
+    prefetch_update();
+    failures += assert_prefetch("New target restarts the dwell", mock_event_count == 0);
+
+    // Repeating the same target keeps its timer running
+    prefetch_request(second);
+    mock_ticks += PREFETCH_DWELL_MS / 2;
+    prefetch_update();
+    deliver_results();
+    failures += assert_prefetch("Only the resting target is read",
+        dir_cache_contains(second) && !dir_cache_contains(first));
+
+    prefetch_request(first);
+    prefetch_request(NULL);
+    mock_ticks += PREFETCH_DWELL_MS;
+    prefetch_update();
+    failures += assert_prefetch("Leaving directories cancels the prefetch", mock_event_count == 0);
+
+    prefetch_shutdown();
+    dir_cache_clear();
+    return failures;
+}
+
+// Run all prefetch tests
+int run_prefetch_tests() {
+    printf("=== Running Prefetch Tests ===\n");
+    int failures = 0;
+
+    snprintf(prefetch_root, sizeof(prefetch_root), "/tmp/romlauncher-prefetch-XXXXXX");
+    if (!mkdtemp(prefetch_root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+
+    failures += test_prefetch_after_dwell();
+    failures += test_prefetch_target_change();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf '%s'", prefetch_root);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", prefetch_root);
+    }
+
+    printf("=== Prefetch Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
@@ -3,6 +3,19 @@
 // Test function prototypes
 int run_path_utils_tests();
 int run_emulator_selection_tests();
+int run_library_tests();
+int run_dir_content_tests();
+int run_collation_tests();
+int run_scanner_tests();
+int run_dir_cache_tests();
+int run_prefetch_tests();
+int run_text_cache_tests();
+int run_perf_tests();
+int run_list_view_tests();
+int run_frame_tests();
+int run_sprite_batch_tests();
+int run_grid_view_tests();
+int run_navigation_tests();
 
 int main() {
     printf("Starting test suite...\n\n");
@@ -12,6 +25,19 @@ int main() {
     
     failures += run_path_utils_tests();
     failures += run_emulator_selection_tests();
+    failures += run_library_tests();
+    failures += run_dir_content_tests();
+    failures += run_collation_tests();
+    failures += run_scanner_tests();
+    failures += run_dir_cache_tests();
+    failures += run_prefetch_tests();
+    failures += run_text_cache_tests();
+    failures += run_perf_tests();
+    failures += run_list_view_tests();
+    failures += run_frame_tests();
+    failures += run_sprite_batch_tests();
+    failures += run_grid_view_tests();
+    failures += run_navigation_tests();
     
     if (failures == 0) {
         printf("All tests passed successfully!\n");
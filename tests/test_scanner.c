@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../source/scanner.h"
+#include "../source/browser.h"
+
+// Test function prototypes
+int test_scanner_batches();
+int test_scanner_cancel();
+
+extern SDL_Event mock_events[];
+extern int mock_event_count;
+
+static char scan_root[256];
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_scan(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static ScanBatch* queued_batch(int i) {
+    return (ScanBatch*)mock_events[i].user.data1;
+}
+
+static void free_queued_batches(void) {
+    for (int i = 0; i < mock_event_count; i++) {
+        scanner_free_batch(queued_batch(i));
+    }
+    mock_event_count = 0;
+}
+
+// Test that a scan streams every entry in growing batches
+int test_scanner_batches() {
+    printf("\nTesting scanner batches:\n");
+    int failures = 0;
+
+    char path[512];
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "%s/dir%d", scan_root, i);
+        mkdir(path, 0755);
+    }
+    for (int i = 0; i < 100; i++) {
+        snprintf(path, sizeof(path), "%s/game %d.sfc", scan_root, i);
+        FILE* fp = fopen(path, "w");
+        if (fp) fclose(fp);
+    }
+
+    mock_event_count = 0;
+    failures += assert_scan("Scan starts", scanner_start(scan_root) == 1);
+    scanner_shutdown();
+
+    // The mock runs the worker inline, so every batch is already queued;
+    // shutting down bumped the generation, so compare against the batches'
+    int generation = mock_event_count > 0 ? queued_batch(0)->generation : -1;
+    int first = mock_event_count > 0 ?
+        queued_batch(0)->entries->dir_count + queued_batch(0)->entries->file_count : 0;
+    failures += assert_scan("First batch is one page", first == ENTRIES_PER_PAGE);
+
+    DirContent* merged = dir_content_create();
+    int growing = 1, done_last = 1, same_scan = 1;
+    int previous = 0;
+    for (int i = 0; i < mock_event_count; i++) {
+        ScanBatch* batch = queued_batch(i);
+        int count = batch->entries->dir_count + batch->entries->file_count;
+        if (!batch->done && count < previous) growing = 0;
+        if (batch->done != (i == mock_event_count - 1)) done_last = 0;
+        if (batch->generation != generation) same_scan = 0;
+        if (mock_events[i].user.code != SCANNER_EVENT_CODE) same_scan = 0;
+        previous = count;
+        dir_content_append(merged, batch->entries);
+    }
+    failures += assert_scan("Batches grow", growing);
+    failures += assert_scan("Only the last batch is marked done", done_last);
+    failures += assert_scan("Batches carry the scan's generation", same_scan);
+    failures += assert_scan("Every entry delivered",
+                            merged->dir_count == 3 && merged->file_count == 100);
+
+    dir_content_sort(merged);
+    failures += assert_scan("Merged entries sort naturally",
+                            strcmp(dir_content_file_name(merged, 99), "game 99.sfc") == 0);
+
+    free_dir_content(merged);
+    free_queued_batches();
+    return failures;
+}
+
+// Test that batches from a cancelled scan are rejected
+int test_scanner_cancel() {
+    printf("\nTesting scanner cancellation:\n");
+    int failures = 0;
+
+    mock_event_count = 0;
+    scanner_start(scan_root);
+    failures += assert_scan("Scan is active", scanner_active());
+
+    // Batches were queued by the inline worker before any cancel
+    ScanBatch* batch = mock_event_count > 0 ? queued_batch(0) : NULL;
+    failures += assert_scan("Current batch accepted", scanner_accept(batch));
+    failures += assert_scan("Last batch finishes the scan",
+                            scanner_accept(queued_batch(mock_event_count - 1)) && !scanner_active());
+
+    scanner_start(scan_root);
+    failures += assert_scan("Batch from an older scan rejected", !scanner_accept(batch));
+    scanner_shutdown();
+
+    free_queued_batches();
+    return failures;
+}
+
+// Run all scanner tests
+int run_scanner_tests() {
+    printf("=== Running Scanner Tests ===\n");
+    int failures = 0;
+
+    snprintf(scan_root, sizeof(scan_root), "/tmp/romlauncher-scan-XXXXXX");
+    if (!mkdtemp(scan_root)) {
+        printf("✗ Could not create temporary directory\n");
+        return 1;
+    }
+
+    failures += test_scanner_batches();
+    failures += test_scanner_cancel();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf '%s'", scan_root);
+    if (system(command) != 0) {
+        printf("[TEST-LOG] Could not remove %s\n", scan_root);
+    }
+
+    printf("=== Scanner Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}
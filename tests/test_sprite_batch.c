@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "../source/sprite_batch.h"
+
+extern int mock_copy_calls;
+extern int mock_geometry_calls;
+extern int mock_geometry_result;
+extern SDL_Vertex mock_geometry_first;
+
+// Test function prototypes
+int test_sprite_batch_geometry();
+int test_sprite_batch_fallback();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_batch(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+static SpriteBatch batch;
+
+static void add_quads(int count) {
+    for (int i = 0; i < count; i++) {
+        SDL_Rect src = { 16, 8, 16, 8 };
+        SDL_Rect dst = { 100 + i * 16, 50, 16, 8 };
+        sprite_batch_add(&batch, &src, &dst);
+    }
+}
+
+// Test that queued quads go out as one geometry call
+int test_sprite_batch_geometry() {
+    printf("\nTesting sprite_batch geometry:\n");
+    int failures = 0;
+    SDL_Color tint = { 10, 20, 30, 255 };
+
+    mock_copy_calls = 0;
+    mock_geometry_calls = 0;
+    sprite_batch_begin(&batch, NULL, NULL, tint);
+    failures += assert_batch("Empty batch draws nothing", sprite_batch_end(&batch) == 0 && mock_geometry_calls == 0);
+
+    sprite_batch_begin(&batch, NULL, NULL, tint);
+    add_quads(20);
+    failures += assert_batch("Batch is drawn as geometry", sprite_batch_end(&batch) == 1);
+    failures += assert_batch("Twenty quads take one call", mock_geometry_calls == 1 && mock_copy_calls == 0);
+
+    // The mock texture is 64x32
+    failures += assert_batch("First corner is placed at dst",
+                             mock_geometry_first.position.x == 100 && mock_geometry_first.position.y == 50);
+    failures += assert_batch("Texture coordinates are normalised",
+                             mock_geometry_first.tex_coord.x == 0.25f && mock_geometry_first.tex_coord.y == 0.25f);
+    failures += assert_batch("Vertices carry the tint",
+                             mock_geometry_first.color.r == 10 && mock_geometry_first.color.b == 30);
+
+    mock_geometry_calls = 0;
+    sprite_batch_begin(&batch, NULL, NULL, tint);
+    add_quads(SPRITE_BATCH_MAX + 1);
+    sprite_batch_end(&batch);
+    failures += assert_batch("Full batch is flushed early", mock_geometry_calls == 2);
+
+    return failures;
+}
+
+// Test that rejected geometry is drawn with copies instead
+int test_sprite_batch_fallback() {
+    printf("\nTesting sprite_batch fallback:\n");
+    int failures = 0;
+    SDL_Color white = { 255, 255, 255, 255 };
+
+    mock_copy_calls = 0;
+    mock_geometry_result = -1;
+    sprite_batch_begin(&batch, NULL, NULL, white);
+    add_quads(5);
+    failures += assert_batch("Rejected geometry reports the fallback", sprite_batch_end(&batch) == 0);
+    failures += assert_batch("Fallback copies each quad", mock_copy_calls == 5);
+    mock_geometry_result = 0;
+
+    return failures;
+}
+
+int run_sprite_batch_tests() {
+    int failures = 0;
+
+    failures += test_sprite_batch_geometry();
+    failures += test_sprite_batch_fallback();
+
+    return failures;
+}
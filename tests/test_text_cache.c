@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+#include "../source/text_cache.h"
+
+extern int mock_render_count;
+
+// Test function prototypes
+int test_text_cache_reuse();
+int test_text_cache_budget();
+
+// Helper function to check test results
+// Returns 0 for success, 1 for failure
+int assert_text(const char* test_name, int condition) {
+    if (condition) {
+        printf("✓ %s\n", test_name);
+        return 0;
+    } else {
+        printf("✗ %s\n", test_name);
+        return 1;
+    }
+}
+
+// Test that the same text, font and colour is rendered once
+int test_text_cache_reuse() {
+    printf("\nTesting text_cache reuse:\n");
+    int failures = 0;
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Color red = { 255, 0, 0, 255 };
+    TTF_Font* font = (TTF_Font*)&failures;
+    SDL_Rect rect = { 0, 0, 0, 0 };
+
+    mock_render_count = 0;
+    SDL_Texture* first = text_cache_acquire(NULL, "Quit", font, white, &rect);
+    text_cache_release(first);
+    SDL_Rect again = { 0, 0, 0, 0 };
+    SDL_Texture* second = text_cache_acquire(NULL, "Quit", font, white, &again);
+    failures += assert_text("Repeated text reuses the texture", first == second && mock_render_count == 1);
+    failures += assert_text("Cached size is reported", again.w == rect.w && again.h == rect.h);
+
+    SDL_Texture* colored = text_cache_acquire(NULL, "Quit", font, red, &rect);
+    SDL_Texture* other_font = text_cache_acquire(NULL, "Quit", (TTF_Font*)&rect, white, &rect);
+    failures += assert_text("Colour and font are part of the key",
+                            colored != second && other_font != second && mock_render_count == 3);
+
+    text_cache_release(second);
+    text_cache_release(colored);
+    text_cache_release(other_font);
+    text_cache_clear();
+    failures += assert_text("Clear empties the cache", text_cache_bytes() == 0);
+    return failures;
+}
+
+// Test that unheld textures are evicted to stay within the byte budget
+int test_text_cache_budget() {
+    printf("\nTesting text_cache budget:\n");
+    int failures = 0;
+    SDL_Color white = { 255, 255, 255, 255 };
+    TTF_Font* font = (TTF_Font*)&failures;
+    SDL_Rect rect;
+
+    // Each 1000 character text is 10000x20 pixels, 800000 bytes
+    char text[1001];
+    memset(text, 'a', 1000);
+    text[1000] = '\0';
+
+    text[0] = 'x';
+    SDL_Texture* held = text_cache_acquire(NULL, text, font, white, &rect);
+    for (char c = 'b'; c <= 'h'; c++) {
+        text[0] = c;
+        text_cache_release(text_cache_acquire(NULL, text, font, white, &rect));
+    }
+    failures += assert_text("Cache stays within budget", text_cache_bytes() <= TEXT_CACHE_MAX_BYTES);
+
+    mock_render_count = 0;
+    text[0] = 'x';
+    SDL_Texture* again = text_cache_acquire(NULL, text, font, white, &rect);
+    failures += assert_text("Held texture never evicted", again == held && mock_render_count == 0);
+    text[0] = 'b';
+    text_cache_release(text_cache_acquire(NULL, text, font, white, &rect));
+    failures += assert_text("Least recently used texture evicted", mock_render_count == 1);
+
+    text_cache_release(held);
+    text_cache_release(again);
+    text_cache_clear();
+    return failures;
+}
+
+// Run all text_cache tests
+int run_text_cache_tests() {
+    printf("=== Running TextCache Tests ===\n");
+    int failures = 0;
+
+    failures += test_text_cache_reuse();
+    failures += test_text_cache_budget();
+
+    printf("=== TextCache Tests Complete ===\n\n");
+    return failures; // Return number of failures
+}